@@ -5,20 +5,36 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <fstream>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <ygm/detail/adaptive_buffer_policy.hpp>
 #include <ygm/detail/byte_vector.hpp>
 #include <ygm/detail/comm_environment.hpp>
 #include <ygm/detail/comm_router.hpp>
 #include <ygm/detail/comm_stats.hpp>
+#include <ygm/detail/compression.hpp>
+#include <ygm/detail/event_tracer.hpp>
+#include <ygm/detail/handler_run_encoder.hpp>
+#include <ygm/detail/hierarchical_reduce.hpp>
 #include <ygm/detail/lambda_map.hpp>
 #include <ygm/detail/layout.hpp>
 #include <ygm/detail/meta/functional.hpp>
 #include <ygm/detail/mpi.hpp>
+#include <ygm/detail/recv_buffer_pool.hpp>
+#include <ygm/detail/rma_transport.hpp>
+#include <ygm/detail/route_combiner.hpp>
+#include <ygm/detail/shm_transport.hpp>
+#include <ygm/detail/trivial_pack.hpp>
 #include <ygm/detail/ygm_cereal_archive.hpp>
 #include <ygm/detail/ygm_ptr.hpp>
 
@@ -35,7 +51,11 @@ class comm {
  private:
   class mpi_irecv_request;
   class mpi_isend_request;
+  class completed_irecv;
+  class queued_isend;
   class header_t;
+  class thread_send_buffers;
+  class async_lock_guard;
   friend class detail::interrupt_mask;
   friend class detail::comm_stats;
 
@@ -58,7 +78,8 @@ class comm {
   void stats_print(const std::string &name = "", std::ostream &os = std::cout);
 
   //
-  //  Asynchronous rpc interfaces.   Can be called inside OpenMP loop
+  //  Asynchronous rpc interfaces.   Can be called inside OpenMP loop when
+  //  YGM_COMM_THREAD_SAFE_ASYNC is set.
   //
 
   template <typename AsyncFunction, typename... SendArgs>
@@ -69,9 +90,33 @@ class comm {
     const_cast<comm *>(this)->async(dest, fn, args...);
   }
 
+  /**
+   * @brief Sends a latency-sensitive message (e.g. a reply) through separate
+   * small buffers that are flushed on every local_progress() and after
+   * incoming messages are processed, instead of waiting behind bulk traffic.
+   */
+  template <typename AsyncFunction, typename... SendArgs>
+  void async_urgent(int dest, AsyncFunction fn, const SendArgs &...args);
+
   template <typename AsyncFunction, typename... SendArgs>
   void async_bcast(AsyncFunction fn, const SendArgs &...args);
 
+  /**
+   * @brief Lets ranks forwarding routed async(dest, fn, args...) messages
+   * merge those that agree on dest, fn and all but the last argument, whose
+   * values are merged with last = combine(last, other).  SendArgs must match
+   * the argument types passed to async().  Ranks that did not register fn
+   * forward its messages unchanged.  Only the first registration of fn's type
+   * is kept, so combine must not depend on per-call state.
+   *
+   * Only active with YGM_COMM_ROUTE_COMBINE=1.  Merged messages are forwarded
+   * after the rest of the receive buffer they arrived in, so they may overtake
+   * or be overtaken by other messages from the same source, and combine must
+   * be associative and commutative.
+   */
+  template <typename... SendArgs, typename AsyncFunction, typename Combiner>
+  void register_route_combiner(AsyncFunction fn, Combiner combine);
+
   template <typename AsyncFunction, typename... SendArgs>
   void async_mcast(const std::vector<int> &dests, AsyncFunction fn,
                    const SendArgs &...args);
@@ -95,6 +140,21 @@ class comm {
 
   void barrier() const { const_cast<comm *>(this)->barrier(); }
 
+  /**
+   * @brief Starts a split-phase barrier, completed by polling barrier_test().
+   * Between the two, the caller may do local work but must not send messages
+   * other than from handlers.
+   */
+  void barrier_begin();
+
+  /**
+   * @brief Makes progress on a barrier started by barrier_begin()
+   *
+   * @return True once all ranks have reached the barrier and every message
+   * has been processed, which ends the barrier
+   */
+  bool barrier_test();
+
   void local_progress();
 
   bool local_process_incoming();
@@ -189,41 +249,136 @@ class comm {
 
   std::pair<uint64_t, uint64_t> barrier_reduce_counts();
 
+  void barrier_reduce_counts_start();
+
+  bool barrier_counts_terminated(
+      const std::pair<uint64_t, uint64_t> &previous_counts,
+      const std::pair<uint64_t, uint64_t> &current_counts) const;
+
   void flush_next_send(std::deque<int> &dest_queue);
   
   void flush_send_buffer(int dest);
 
+  ygm::detail::byte_vector &urgent_buffer(int dest);
+
+  void flush_urgent_buffers();
+
+  int compress_send_buffer(int dest,
+                           std::shared_ptr<ygm::detail::byte_vector> &buffer);
+
+  void post_isend(int dest, int tag,
+                  std::shared_ptr<ygm::detail::byte_vector> &buffer);
+
+  void isend_send_buffer(int dest,
+                         std::shared_ptr<ygm::detail::byte_vector> &buffer);
+
+  bool uses_transport(int dest) const;
+
+  bool transport_push(int dest, const ygm::detail::byte_vector &buffer);
+
+  bool transport_drained(int dest) const;
+
+  void backlog_send_buffer(int dest);
+
+  void drain_transport_backlog();
+
+  void reset_transport_bypass();
+
+  std::shared_ptr<ygm::detail::byte_vector> get_free_send_buffer();
+
   void handle_completed_send(mpi_isend_request &req_buffer);
 
+  void recycle_send_buffer(std::shared_ptr<ygm::detail::byte_vector> &buffer);
+
   void check_completed_sends();
 
+  bool sends_in_flight() const;
+
   void check_if_production_halt_required();
 
   void flush_all_local_and_process_incoming();
 
   void flush_to_capacity();
 
+  void flush_if_over_threshold(int dest);
+
+  void queue_send_dest(int dest);
+
+  void flush_expired_buffers();
+
+  detail::route_combiner *find_route_combiner(const std::byte *data) const;
+
+  void forward_routed_message(int dest, cereal::YGMInputArchive &iarchive,
+                              size_t message_size);
+
+  size_t send_buffer_reserve_size(int dest) const;
+
   void post_new_irecv(std::shared_ptr<ygm::detail::byte_vector> &recv_buffer);
 
+  bool probe_new_irecvs();
+
   template <typename Lambda, typename... PackArgs>
-  size_t pack_lambda(ygm::detail::byte_vector &packed, Lambda l,
+  static auto make_dispatch_lambda();
+
+  template <typename Lambda, typename RemoteLogicLambda>
+  static uint16_t register_handler();
+
+  template <typename Lambda, typename... PackArgs>
+  size_t pack_lambda(ygm::detail::byte_vector  &packed,
+                     detail::string_dictionary *dictionary, Lambda l,
                      const PackArgs &...args);
 
   template <typename Lambda, typename... PackArgs>
   void pack_lambda_broadcast(Lambda l, const PackArgs &...args);
 
   template <typename Lambda, typename RemoteLogicLambda, typename... PackArgs>
-  size_t pack_lambda_generic(ygm::detail::byte_vector &packed, Lambda l,
+  size_t pack_lambda_generic(ygm::detail::byte_vector  &packed,
+                             detail::string_dictionary *dictionary, Lambda l,
                              RemoteLogicLambda rll, const PackArgs &...args);
 
+  template <typename AsyncFunction, typename... SendArgs>
+  void async_thread_buffered(int dest, AsyncFunction fn,
+                             const SendArgs &...args);
+
+  thread_send_buffers &local_thread_send_buffers();
+
+  void coalesce_thread_send_buffers(thread_send_buffers &tsb);
+
+  bool coalesce_all_thread_send_buffers();
+
+  bool holds_async_lock() const;
+
   void queue_message_bytes(const ygm::detail::byte_vector             &packed,
                            const int                     dest);
 
   void handle_next_receive(std::shared_ptr<ygm::detail::byte_vector> &buffer,
-                           const size_t                 buffer_size);
+                           const size_t buffer_size, const int tag);
+
+  void dispatch_receive_buffer(std::byte *data, const size_t size,
+                               bool urgent = false);
+
+  void execute_next_handler(cereal::YGMInputArchive &iarchive);
+
+  void execute_handler(uint16_t lid, cereal::YGMInputArchive &iarchive);
+
+  bool shm_process_incoming();
+
+  bool rma_process_incoming();
 
   bool process_receive_queue();
 
+  void progress_thread_start();
+
+  void progress_thread_stop();
+
+  void progress_thread_loop();
+
+  bool progress_thread_dispatch_incoming();
+
+  void stats_print_handler_profile(std::ostream &os);
+
+  void stats_print_traffic(std::ostream &os);
+
   template <typename... Args>
   std::string outstr(Args &&...args) const;
 
@@ -240,6 +395,15 @@ class comm {
 
   MPI_Comm m_comm_async;
   MPI_Comm m_comm_barrier;
+
+  // Termination detection state for barrier()
+  std::unique_ptr<detail::hierarchical_count_reducer> m_count_reducer;
+  std::pair<uint64_t, uint64_t>                       m_last_barrier_counts{0, 0};
+
+  // Split-phase barrier state (barrier_begin / barrier_test)
+  bool                          m_split_barrier_active = false;
+  std::pair<uint64_t, uint64_t> m_split_barrier_previous_counts;
+  std::pair<uint64_t, uint64_t> m_split_barrier_current_counts;
   MPI_Comm m_comm_other;
 
   std::vector<ygm::detail::byte_vector> m_vec_send_buffers;
@@ -248,12 +412,47 @@ class comm {
   std::deque<int>                     m_send_local_dest_queue;
   size_t                              m_send_remote_buffer_bytes = 0;
   std::deque<int>                     m_send_remote_dest_queue;
+  // Whether each dest is in a dest queue, which buffers flushed out of order
+  // (adaptive policy, shm and rma transports, expiry) still are
+  std::vector<bool>                   m_send_dest_queued;
+
+  // MPI_Wtime() of the first message in each send buffer, and (time, dest)
+  // for every buffer started, in time order.  Used only when
+  // YGM_COMM_MAX_BUFFER_AGE_US is set.
+  std::vector<double>                 m_send_buffer_start_times;
+  std::deque<std::pair<double, int>>  m_send_buffer_expiry_queue;
+
+  // Priority lane of async_urgent(), flushed eagerly and sent with tag_urgent
+  // so that routing hops keep forwarding it eagerly
+  std::vector<ygm::detail::byte_vector> m_vec_urgent_buffers;
+  std::deque<int>                       m_urgent_dest_queue;
+  size_t                                m_urgent_buffer_bytes = 0;
+
+  // Per-destination buffer sizing (YGM_COMM_ADAPTIVE_BUFFERS)
+  std::unique_ptr<detail::adaptive_buffer_policy> m_buffer_policy;
+
+  // Combiners for routed messages, indexed by handler id
+  std::vector<std::unique_ptr<detail::route_combiner>> m_route_combiners;
+
+  // Runs of messages sharing a handler (YGM_COMM_AGGREGATE_HANDLERS)
+  std::unique_ptr<detail::handler_run_encoder> m_handler_runs;
+
+  // Encoding of async arguments (YGM_COMM_ARCHIVE).  Send dictionaries are
+  // only used by async(), as other messages may be copied to several buffers.
+  detail::archive_options                m_pack_options;
+  std::vector<detail::string_dictionary> m_send_dictionaries;
 
   std::deque<mpi_irecv_request>                        m_recv_queue;
+  detail::recv_buffer_pool                             m_recv_buffer_pool;
   std::deque<mpi_isend_request>                        m_send_queue;
   std::vector<std::shared_ptr<ygm::detail::byte_vector>> m_free_send_buffers;
 
-  size_t m_pending_isend_bytes = 0;
+  // Requests made by MPI_Recv_init for each receive buffer
+  // (YGM_COMM_PERSISTENT_RECV)
+  std::unordered_map<const ygm::detail::byte_vector *, MPI_Request>
+      m_persistent_recvs;
+
+  std::atomic<size_t> m_pending_isend_bytes = 0;
 
   std::deque<std::function<void()>> m_pre_barrier_callbacks;
 
@@ -264,6 +463,54 @@ class comm {
 
   bool m_in_process_receive_queue = false;
 
+  // Dedicated progress thread state (YGM_COMM_PROGRESS_THREAD).  When enabled,
+  // the progress thread owns m_send_queue and m_recv_queue; the handoff queues
+  // below are guarded by m_progress_mutex.
+  bool                                                   m_progress_thread_enabled = false;
+  std::thread                                            m_progress_thread;
+  std::atomic<bool>                                      m_progress_thread_stop = false;
+  std::mutex                                             m_progress_mutex;
+  std::deque<queued_isend>                               m_progress_outbox;
+  std::deque<completed_irecv>                            m_progress_inbox;
+  std::vector<std::shared_ptr<ygm::detail::byte_vector>> m_progress_repost;
+
+  // Thread-safe async state (YGM_COMM_THREAD_SAFE_ASYNC).  Each calling thread
+  // packs into its own thread_send_buffers, which are coalesced into
+  // m_vec_send_buffers under m_async_mutex.
+  bool                                              m_thread_safe_async = false;
+  uint64_t                                          m_instance_id       = 0;
+  std::recursive_mutex                              m_async_mutex;
+  std::atomic<std::thread::id>                      m_async_lock_owner;
+  size_t                                            m_async_lock_depth = 0;
+  std::vector<std::unique_ptr<thread_send_buffers>> m_thread_send_buffers;
+
+  // On-node shared memory rings (YGM_COMM_SHM_TRANSPORT)
+  std::unique_ptr<detail::shm_transport> m_shm;
+
+  // One-sided receive slots (YGM_COMM_RMA_TRANSPORT)
+  std::unique_ptr<detail::rma_transport> m_rma;
+
+  // Buffers flushed while a transport had no room for them, per dest.  A dest
+  // only falls back to MPI once the transport holds nothing of ours for it,
+  // and then stays on MPI (m_transport_bypass) until the next barrier.
+  std::vector<std::deque<std::shared_ptr<ygm::detail::byte_vector>>>
+                    m_transport_backlog;
+  std::vector<int>  m_transport_backlog_dests;
+  size_t            m_transport_backlog_bytes = 0;
+  std::vector<bool> m_transport_bypass;
+
+  // Send buffer compression (YGM_COMM_COMPRESS).  Compressed buffers are sent
+  // with tag_compressed so receivers know to decompress them.
+  static constexpr int     tag_raw        = 0;
+  static constexpr int     tag_compressed = 1;
+  static constexpr int     tag_urgent     = 2;
+  detail::lz_codec         m_codec;
+  ygm::detail::byte_vector m_compress_buffer;
+  detail::recv_buffer_pool m_decompress_buffer_pool;
+
+  // Chrome trace event recorder (YGM_COMM_TRACE_FILE)
+  std::unique_ptr<detail::event_tracer> m_tracer;
+
   detail::comm_stats             stats;
   const detail::layout           m_layout;
   const detail::comm_environment config = detail::comm_environment(m_layout);
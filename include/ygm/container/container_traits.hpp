@@ -16,6 +16,12 @@ struct map_tag;
 struct multimap_tag;
 struct set_tag;
 
+// Storage policies for the local partition of a container
+/// Node-based standard library containers
+struct node_storage {};
+/// Flat, contiguous containers (open-addressing hash table for map)
+struct flat_storage {};
+
 // General template used as a base case
 template <class Container, typename = void>
 struct has_container_type : std::false_type {};
@@ -143,7 +143,7 @@ class counting_set
   void serialize(const std::string &fname) { m_map.serialize(fname); }
   void deserialize(const std::string &fname) { m_map.deserialize(fname); }
 
-  detail::hash_partitioner<std::hash<key_type>> partitioner;
+  detail::hash_partitioner<detail::lookup_hash<key_type>> partitioner;
 
  private:
   void cache_erase(const key_type &key) {
@@ -7,6 +7,7 @@
 
 #include <tuple>
 #include <utility>
+#include <ygm/container/detail/lookup_key.hpp>
 #include <ygm/detail/lambda_compliance.hpp>
 #include <ygm/detail/meta/functional.hpp>
 
@@ -36,6 +37,35 @@ struct base_async_contains {
     derived_this->comm().async(dest, lambda, derived_this->get_ygm_ptr(), value,
                                args...);
   }
+
+  /**
+   * @brief async_contains by std::string_view, which the owner reads in place
+   * from its receive buffer without building a std::string
+   */
+  template <typename LookupValue, typename Function, typename... FuncArgs>
+  void async_contains(const LookupValue& value, Function fn,
+                      const FuncArgs&... args)
+    requires LookupKeyFor<LookupValue,
+                          typename std::tuple_element<0, for_all_args>::type>
+  {
+    YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(Function,
+                                      "ygm::container::async_contains()");
+
+    derived_type* derived_this = static_cast<derived_type*>(this);
+
+    int dest = derived_this->partitioner.owner(value);
+
+    auto lambda = [fn](auto pcont, const LookupValue& value,
+                       const FuncArgs&... args) mutable {
+      bool contains = static_cast<bool>(pcont->local_count(value));
+      ygm::meta::apply_optional(
+          fn, std::make_tuple(pcont),
+          std::forward_as_tuple(contains, value, args...));
+    };
+
+    derived_this->comm().async(dest, lambda, derived_this->get_ygm_ptr(), value,
+                               args...);
+  }
 };
 
 }  // namespace ygm::container::detail
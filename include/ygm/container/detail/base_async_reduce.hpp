@@ -6,6 +6,7 @@
 #pragma once
 
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <ygm/container/detail/base_concepts.hpp>
 #include <ygm/detail/lambda_compliance.hpp>
@@ -33,6 +34,22 @@ struct base_async_reduce {
           pcont->local_reduce(key, value, reducer);
         };
 
+    // With YGM_COMM_ROUTE_COMBINE, ranks forwarding routed reductions may
+    // pre-reduce equal keys.  This reorders messages and requires reducer to
+    // be associative and commutative.  The combiner outlives this call, so
+    // only stateless reducers can be used.
+    if constexpr (std::is_empty_v<ReductionOp>) {
+      using value_type = typename std::tuple_element<1, for_all_args>::type;
+      derived_this->comm()
+          .template register_route_combiner<
+              std::decay_t<decltype(derived_this->get_ygm_ptr())>,
+              typename std::tuple_element<0, for_all_args>::type, value_type>(
+              rlambda,
+              [reducer](const value_type& a, const value_type& b) mutable {
+                return reducer(a, b);
+              });
+    }
+
     derived_this->comm().async(dest, rlambda, derived_this->get_ygm_ptr(), key,
                                value);
   }
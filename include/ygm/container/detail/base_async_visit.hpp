@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
 #include <tuple>
 #include <utility>
+#include <vector>
 #include <ygm/container/detail/base_concepts.hpp>
+#include <ygm/container/detail/lookup_key.hpp>
 #include <ygm/detail/interrupt_mask.hpp>
 #include <ygm/detail/lambda_compliance.hpp>
 
@@ -85,6 +89,111 @@ struct base_async_visit {
                                args...);
   }
 
+  /**
+   * @brief async_visit by std::string_view.  The owner looks the key up in
+   * place in its receive buffer and only builds a std::string to insert it.
+   */
+  template <typename LookupKey, typename Visitor, typename... VisitorArgs>
+  void async_visit(const LookupKey& key, Visitor visitor,
+                   const VisitorArgs&... args)
+    requires DoubleItemTuple<for_all_args> &&
+             LookupKeyFor<LookupKey,
+                          typename std::tuple_element<0, for_all_args>::type>
+  {
+    YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(Visitor, "ygm::container::async_visit()");
+
+    derived_type* derived_this = static_cast<derived_type*>(this);
+
+    int dest = derived_this->partitioner.owner(key);
+
+    auto vlambda = [visitor](auto pcont, const LookupKey& key,
+                             const VisitorArgs&... args) mutable {
+      pcont->local_visit(key, visitor, args...);
+    };
+
+    derived_this->comm().async(dest, vlambda, derived_this->get_ygm_ptr(), key,
+                               args...);
+  }
+
+  /**
+   * @brief async_visit_if_contains by std::string_view, looked up in place
+   * in the owner's receive buffer
+   */
+  template <typename LookupKey, typename Visitor, typename... VisitorArgs>
+  void async_visit_if_contains(const LookupKey& key, Visitor visitor,
+                               const VisitorArgs&... args)
+    requires DoubleItemTuple<for_all_args> &&
+             LookupKeyFor<LookupKey,
+                          typename std::tuple_element<0, for_all_args>::type>
+  {
+    YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(
+        Visitor, "ygm::container::async_visit_if_contains()");
+
+    derived_type* derived_this = static_cast<derived_type*>(this);
+
+    int dest = derived_this->partitioner.owner(key);
+
+    auto vlambda = [visitor](auto pcont, const LookupKey& key,
+                             const VisitorArgs&... args) mutable {
+      pcont->local_visit_if_contains(key, visitor, args...);
+    };
+
+    derived_this->comm().async(dest, vlambda, derived_this->get_ygm_ptr(), key,
+                               args...);
+  }
+
+  /**
+   * @brief async_visit over a batch of keys.  Keys are grouped by owner and
+   * each owner receives a single message carrying its keys, which are visited
+   * in order from one handler dispatch.
+   */
+  template <typename Visitor, typename... VisitorArgs>
+  void async_visit_batch(
+      const std::vector<typename std::tuple_element<0, for_all_args>::type>&
+              keys,
+      Visitor visitor, const VisitorArgs&... args)
+    requires DoubleItemTuple<for_all_args>
+  {
+    YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(Visitor,
+                                      "ygm::container::async_visit_batch()");
+
+    using key_type = typename std::tuple_element<0, for_all_args>::type;
+
+    derived_type* derived_this = static_cast<derived_type*>(this);
+
+    // Sorting by owner keeps the work independent of the number of ranks
+    std::vector<int> owners(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      owners[i] = derived_this->partitioner.owner(keys[i]);
+    }
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&owners](size_t a, size_t b) {
+                       return owners[a] < owners[b];
+                     });
+
+    auto vlambda = [visitor](auto pcont, const std::vector<key_type>& keys,
+                             const VisitorArgs&... args) mutable {
+      for (const auto& key : keys) {
+        pcont->local_visit(key, visitor, args...);
+      }
+    };
+
+    std::vector<key_type> batch;
+    for (size_t begin = 0; begin < order.size();) {
+      int    dest = owners[order[begin]];
+      size_t end  = begin;
+      batch.clear();
+      for (; end < order.size() && owners[order[end]] == dest; ++end) {
+        batch.push_back(keys[order[end]]);
+      }
+      derived_this->comm().async(dest, vlambda, derived_this->get_ygm_ptr(),
+                                 batch, args...);
+      begin = end;
+    }
+  }
+
   // todo:   async_insert_visit()
 };
 
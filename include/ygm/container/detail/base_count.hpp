@@ -8,6 +8,7 @@
 #include <tuple>
 #include <utility>
 #include <ygm/collective.hpp>
+#include <ygm/container/detail/lookup_key.hpp>
 
 namespace ygm::container::detail {
 
@@ -18,6 +19,16 @@ struct base_count {
     derived_this->comm().barrier();
     return ygm::sum(derived_this->local_count(value), derived_this->comm());
   }
+
+  template <typename LookupValue>
+  size_t count(const LookupValue& value) const
+    requires LookupKeyFor<LookupValue,
+                          typename std::tuple_element<0, for_all_args>::type>
+  {
+    const derived_type* derived_this = static_cast<const derived_type*>(this);
+    derived_this->comm().barrier();
+    return ygm::sum(derived_this->local_count(value), derived_this->comm());
+  }
 };
 
 }  // namespace ygm::container::detail
\ No newline at end of file
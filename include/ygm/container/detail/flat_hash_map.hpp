@@ -0,0 +1,449 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ygm::container::detail {
+
+// Lookup argument type: any K when Hash and KeyEqual are transparent,
+// otherwise Key.  An alias of K stays deducible.
+template <bool Transparent>
+struct flat_hash_map_key_arg {
+  template <typename K, typename Key>
+  using type = Key;
+};
+
+template <>
+struct flat_hash_map_key_arg<true> {
+  template <typename K, typename Key>
+  using type = K;
+};
+
+template <typename T, typename = void>
+struct is_transparent : std::false_type {};
+
+template <typename T>
+struct is_transparent<T, std::void_t<typename T::is_transparent>>
+    : std::true_type {};
+
+/**
+ * @brief Open-addressing hash table used as the local partition of a map with
+ * flat storage.
+ *
+ * Entries live inline in a single array beside one control byte per slot
+ * holding 7 bits of their hash, in the style of SwissTable.  Slots are probed
+ * a group of 16 at a time: the group's control bytes are matched in one SSE2
+ * comparison (or a byte loop without SSE2) and only matching slots have their
+ * keys compared.  Erased slots become tombstones unless their group still has
+ * an empty slot, and the table grows at a load factor of 7/8.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+  static constexpr size_t group_width  = 16;
+  static constexpr int8_t ctrl_empty   = -128;
+  static constexpr int8_t ctrl_deleted = -2;
+  static constexpr size_t npos         = size_t(-1);
+
+  template <typename K>
+  using key_arg = typename flat_hash_map_key_arg<
+      is_transparent<Hash>::value &&
+      is_transparent<KeyEqual>::value>::template type<K, Key>;
+
+ public:
+  using key_type    = Key;
+  using mapped_type = Value;
+  using value_type  = std::pair<Key, Value>;
+  using size_type   = size_t;
+  using hasher      = Hash;
+  using key_equal   = KeyEqual;
+
+  template <bool Const>
+  class basic_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::pair<Key, Value>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer =
+        std::conditional_t<Const, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<Const, const value_type &, value_type &>;
+
+    basic_iterator() = default;
+
+    basic_iterator(const int8_t *ctrl, const int8_t *ctrl_end,
+                   pointer slot)
+        : m_ctrl(ctrl), m_ctrl_end(ctrl_end), m_slot(slot) {
+      skip_free();
+    }
+
+    // Allows iterator -> const_iterator
+    operator basic_iterator<true>() const
+      requires(!Const)
+    {
+      return basic_iterator<true>(m_ctrl, m_ctrl_end, m_slot);
+    }
+
+    reference operator*() const { return *m_slot; }
+    pointer   operator->() const { return m_slot; }
+
+    basic_iterator &operator++() {
+      ++m_ctrl;
+      ++m_slot;
+      skip_free();
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator to_return = *this;
+      ++(*this);
+      return to_return;
+    }
+
+    bool operator==(const basic_iterator &other) const {
+      return m_ctrl == other.m_ctrl;
+    }
+
+   private:
+    void skip_free() {
+      while (m_ctrl != m_ctrl_end && *m_ctrl < 0) {
+        ++m_ctrl;
+        ++m_slot;
+      }
+    }
+
+    const int8_t *m_ctrl     = nullptr;
+    const int8_t *m_ctrl_end = nullptr;
+    pointer       m_slot     = nullptr;
+  };
+
+  using iterator       = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  flat_hash_map() = default;
+
+  flat_hash_map(const flat_hash_map &other)
+      : m_hasher(other.m_hasher), m_equal(other.m_equal) {
+    reserve(other.size());
+    for (const value_type &kv : other) {
+      try_emplace(kv.first, kv.second);
+    }
+  }
+
+  flat_hash_map(flat_hash_map &&other) noexcept { swap(other); }
+
+  flat_hash_map &operator=(flat_hash_map other) {
+    swap(other);
+    return *this;
+  }
+
+  ~flat_hash_map() { release(); }
+
+  iterator begin() { return iterator_at(0); }
+  iterator end() { return iterator_at(capacity()); }
+
+  const_iterator begin() const { return iterator_at(0); }
+  const_iterator end() const { return iterator_at(capacity()); }
+
+  size_t size() const { return m_size; }
+  bool   empty() const { return m_size == 0; }
+  size_t capacity() const { return m_groups * group_width; }
+
+  template <typename K = key_type>
+  iterator find(const key_arg<K> &key) {
+    size_t i = find_index(key);
+    return i == npos ? end() : iterator_at(i);
+  }
+
+  template <typename K = key_type>
+  const_iterator find(const key_arg<K> &key) const {
+    size_t i = find_index(key);
+    return i == npos ? end() : iterator_at(i);
+  }
+
+  template <typename K = key_type>
+  size_t count(const key_arg<K> &key) const {
+    return find_index(key) != npos;
+  }
+
+  template <typename K = key_type>
+  bool contains(const key_arg<K> &key) const {
+    return find_index(key) != npos;
+  }
+
+  template <typename K = key_type>
+  std::pair<iterator, iterator> equal_range(const key_arg<K> &key) {
+    iterator itr = find<K>(key);
+    return {itr, itr == end() ? itr : std::next(itr)};
+  }
+
+  template <typename K = key_type>
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_arg<K> &key) const {
+    const_iterator itr = find<K>(key);
+    return {itr, itr == end() ? itr : std::next(itr)};
+  }
+
+  template <typename K = key_type>
+  mapped_type &at(const key_arg<K> &key) {
+    size_t i = find_index(key);
+    if (i == npos) {
+      throw std::out_of_range("flat_hash_map::at");
+    }
+    return m_slots[i].second;
+  }
+
+  template <typename K = key_type>
+  const mapped_type &at(const key_arg<K> &key) const {
+    return const_cast<flat_hash_map *>(this)->at<K>(key);
+  }
+
+  mapped_type &operator[](const key_type &key) {
+    return try_emplace(key).first->second;
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+    size_t i = find_index(key);
+    if (i != npos) {
+      return {iterator_at(i), false};
+    }
+    if (m_growth_left == 0) {
+      grow();
+    }
+    size_t h = hash_of(key);
+    i        = find_free(h);
+    if (m_ctrl[i] == ctrl_empty) {
+      --m_growth_left;
+    }
+    m_ctrl[i] = int8_t(h & 0x7f);
+    new (m_slots + i) value_type(
+        std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    ++m_size;
+    return {iterator_at(i), true};
+  }
+
+  std::pair<iterator, bool> insert(const value_type &kv) {
+    return try_emplace(kv.first, kv.second);
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&value) {
+    auto [itr, inserted] = try_emplace(key, std::forward<M>(value));
+    if (!inserted) {
+      itr->second = std::forward<M>(value);
+    }
+    return {itr, inserted};
+  }
+
+  template <typename K = key_type>
+  size_t erase(const key_arg<K> &key)
+    requires(!std::is_convertible_v<const K &, const_iterator>)
+  {
+    size_t i = find_index(key);
+    if (i == npos) {
+      return 0;
+    }
+    erase_index(i);
+    return 1;
+  }
+
+  void erase(const_iterator itr) { erase_index(&*itr - m_slots); }
+
+  void clear() {
+    destroy_all();
+    if (m_groups > 0) {
+      std::memset(m_ctrl, ctrl_empty, capacity());
+    }
+    m_size        = 0;
+    m_growth_left = max_load(capacity());
+  }
+
+  void reserve(size_t count) {
+    size_t groups = m_groups == 0 ? 1 : m_groups;
+    while (max_load(groups * group_width) < count) {
+      groups *= 2;
+    }
+    if (groups != m_groups) {
+      rehash(groups);
+    }
+  }
+
+  void swap(flat_hash_map &other) noexcept {
+    std::swap(m_ctrl, other.m_ctrl);
+    std::swap(m_slots, other.m_slots);
+    std::swap(m_groups, other.m_groups);
+    std::swap(m_size, other.m_size);
+    std::swap(m_growth_left, other.m_growth_left);
+    std::swap(m_hasher, other.m_hasher);
+    std::swap(m_equal, other.m_equal);
+  }
+
+ private:
+  static size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+  // Bit i is set for each control byte of the group equal to c
+  static uint32_t match(const int8_t *group, int8_t c) {
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(c)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < group_width; ++i) {
+      mask |= uint32_t(group[i] == c) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Bit i is set for each empty or deleted slot of the group
+  static uint32_t match_free(const int8_t *group) {
+#if defined(__SSE2__)
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < group_width; ++i) {
+      mask |= uint32_t(group[i] < 0) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Mixed so that keys sharing an owner rank still spread over the table
+  template <typename K>
+  size_t hash_of(const K &key) const {
+    uint64_t h = uint64_t(m_hasher(key)) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 32);
+  }
+
+  template <typename K>
+  size_t find_index(const K &key) const {
+    if (m_groups == 0) {
+      return npos;
+    }
+    size_t h     = hash_of(key);
+    size_t group = (h >> 7) & (m_groups - 1);
+    for (size_t step = 1;; ++step) {
+      const int8_t *ctrl = m_ctrl + group * group_width;
+      for (uint32_t m = match(ctrl, int8_t(h & 0x7f)); m != 0; m &= m - 1) {
+        size_t i = group * group_width + std::countr_zero(m);
+        if (m_equal(m_slots[i].first, key)) {
+          return i;
+        }
+      }
+      if (match(ctrl, ctrl_empty) != 0) {
+        return npos;
+      }
+      // Triangular steps visit every group of a power-of-two table
+      group = (group + step) & (m_groups - 1);
+    }
+  }
+
+  size_t find_free(size_t h) const {
+    size_t group = (h >> 7) & (m_groups - 1);
+    for (size_t step = 1;; ++step) {
+      uint32_t m = match_free(m_ctrl + group * group_width);
+      if (m != 0) {
+        return group * group_width + std::countr_zero(m);
+      }
+      group = (group + step) & (m_groups - 1);
+    }
+  }
+
+  void erase_index(size_t i) {
+    m_slots[i].~value_type();
+    --m_size;
+    // No probe passes a group that still has an empty slot
+    if (match(m_ctrl + i / group_width * group_width, ctrl_empty) != 0) {
+      m_ctrl[i] = ctrl_empty;
+      ++m_growth_left;
+    } else {
+      m_ctrl[i] = ctrl_deleted;
+    }
+  }
+
+  void grow() {
+    if (m_groups == 0) {
+      rehash(1);
+    } else if (m_size < max_load(capacity()) / 2) {
+      // Mostly tombstones, rebuild in place
+      rehash(m_groups);
+    } else {
+      rehash(m_groups * 2);
+    }
+  }
+
+  void rehash(size_t groups) {
+    flat_hash_map other;
+    other.m_hasher      = m_hasher;
+    other.m_equal       = m_equal;
+    other.m_groups      = groups;
+    other.m_ctrl        = new int8_t[groups * group_width];
+    other.m_slots       = std::allocator<value_type>().allocate(
+        groups * group_width);
+    other.m_growth_left = max_load(groups * group_width);
+    std::memset(other.m_ctrl, ctrl_empty, groups * group_width);
+
+    for (size_t i = 0; i < capacity(); ++i) {
+      if (m_ctrl[i] >= 0) {
+        size_t j        = other.find_free(hash_of(m_slots[i].first));
+        other.m_ctrl[j] = m_ctrl[i];
+        new (other.m_slots + j) value_type(std::move(m_slots[i]));
+        --other.m_growth_left;
+        ++other.m_size;
+      }
+    }
+    swap(other);
+  }
+
+  void destroy_all() {
+    for (size_t i = 0; i < capacity(); ++i) {
+      if (m_ctrl[i] >= 0) {
+        m_slots[i].~value_type();
+      }
+    }
+  }
+
+  void release() {
+    if (m_groups > 0) {
+      destroy_all();
+      std::allocator<value_type>().deallocate(m_slots, capacity());
+      delete[] m_ctrl;
+    }
+  }
+
+  iterator iterator_at(size_t i) {
+    return iterator(m_ctrl + i, m_ctrl + capacity(), m_slots + i);
+  }
+
+  const_iterator iterator_at(size_t i) const {
+    return const_iterator(m_ctrl + i, m_ctrl + capacity(), m_slots + i);
+  }
+
+  int8_t     *m_ctrl        = nullptr;
+  value_type *m_slots       = nullptr;
+  size_t      m_groups      = 0;
+  size_t      m_size        = 0;
+  size_t      m_growth_left = 0;
+  Hash        m_hasher;
+  KeyEqual    m_equal;
+};
+
+}  // namespace ygm::container::detail
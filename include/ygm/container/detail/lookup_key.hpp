@@ -0,0 +1,49 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <concepts>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ygm::container::detail {
+
+/**
+ * @brief Hash for partitioning and storing keys.  For std::string it is
+ * transparent, so std::string_view keys are found without building a string.
+ * Both give the same values as std::hash<Key>.
+ */
+template <typename Key>
+struct lookup_hash : std::hash<Key> {};
+
+template <>
+struct lookup_hash<std::string> {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view key) const noexcept {
+    return std::hash<std::string_view>{}(key);
+  }
+};
+
+template <typename Key>
+using lookup_equal = std::conditional_t<std::is_same_v<Key, std::string>,
+                                        std::equal_to<>, std::equal_to<Key>>;
+
+template <typename Key>
+using lookup_less = std::conditional_t<std::is_same_v<Key, std::string>,
+                                       std::less<>, std::less<Key>>;
+
+/**
+ * @brief Types that lookups accept in place of Key, deserialized without a
+ * copy from the receive buffer
+ */
+template <typename LookupKey, typename Key>
+concept LookupKeyFor = std::same_as<Key, std::string> &&
+                       std::same_as<LookupKey, std::string_view>;
+
+}  // namespace ygm::container::detail
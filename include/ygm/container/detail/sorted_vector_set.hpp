@@ -0,0 +1,167 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace ygm::container::detail {
+
+/**
+ * @brief Sorted vector used as the local partition of a set or multiset with
+ * flat storage.
+ *
+ * Inserts are appended to an unsorted log in O(1).  flush() sorts the log,
+ * merges it into the sorted values and, unless Multi, drops duplicates.  The
+ * owning container flushes before each barrier.  Lookups binary search the
+ * sorted values and scan the log, flushing only once the log outgrows
+ * max_log_scan(), so interleaved inserts and lookups stay sublinear.  Erases
+ * flush and then shift the vector, so this suits build-once, query-many
+ * partitions.
+ */
+template <typename Value, bool Multi, typename Compare = std::less<Value>>
+class sorted_vector_set {
+ public:
+  using value_type     = Value;
+  using size_type      = size_t;
+  using const_iterator = typename std::vector<Value>::const_iterator;
+  using iterator       = const_iterator;
+
+  void insert(const value_type &val) { m_log.push_back(val); }
+
+  size_t erase(const value_type &val) {
+    flush();
+    auto [first, last] =
+        std::equal_range(m_sorted.begin(), m_sorted.end(), val, m_compare);
+    size_t erased = std::distance(first, last);
+    m_sorted.erase(first, last);
+    return erased;
+  }
+
+  // Any K that Compare can order against Value, e.g. std::string_view with
+  // std::less<>
+  template <typename K>
+  size_t count(const K &val) const {
+    flush_if_log_large();
+    auto [first, last] =
+        std::equal_range(m_sorted.begin(), m_sorted.end(), val, m_compare);
+    size_t found = std::distance(first, last);
+    if constexpr (!Multi) {
+      return (found > 0 || log_contains(val)) ? 1 : 0;
+    } else {
+      for (const value_type &v : m_log) {
+        found += equivalent(v, val);
+      }
+      return found;
+    }
+  }
+
+  template <typename K>
+  bool contains(const K &val) const {
+    flush_if_log_large();
+    return std::binary_search(m_sorted.begin(), m_sorted.end(), val,
+                              m_compare) ||
+           log_contains(val);
+  }
+
+  size_t size() const {
+    flush();
+    return m_sorted.size();
+  }
+
+  bool empty() const { return size() == 0; }
+
+  const_iterator begin() const {
+    flush();
+    return m_sorted.cbegin();
+  }
+
+  const_iterator end() const { return m_sorted.cend(); }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  void clear() {
+    m_sorted.clear();
+    m_log.clear();
+  }
+
+  void swap(sorted_vector_set &other) {
+    m_sorted.swap(other.m_sorted);
+    m_log.swap(other.m_log);
+  }
+
+  /**
+   * @brief True if values were inserted since the last flush()
+   */
+  bool has_pending() const { return !m_log.empty(); }
+
+  /**
+   * @brief Sorts pending inserts into the sorted values
+   */
+  void flush() const {
+    if (m_log.empty()) {
+      return;
+    }
+    std::sort(m_log.begin(), m_log.end(), m_compare);
+    if constexpr (!Multi) {
+      m_log.erase(std::unique(m_log.begin(), m_log.end(), equivalent()),
+                  m_log.end());
+    }
+    size_t middle = m_sorted.size();
+    m_sorted.insert(m_sorted.end(), m_log.begin(), m_log.end());
+    std::inplace_merge(m_sorted.begin(), m_sorted.begin() + middle,
+                       m_sorted.end(), m_compare);
+    if constexpr (!Multi) {
+      m_sorted.erase(std::unique(m_sorted.begin(), m_sorted.end(),
+                                 equivalent()),
+                     m_sorted.end());
+    }
+    m_log.clear();
+  }
+
+ private:
+  // Longest log a lookup scans before flushing it, balancing the scan against
+  // the O(size()) merge of a flush
+  size_t max_log_scan() const {
+    return std::max(min_log_scan, size_t(std::sqrt(double(m_sorted.size()))));
+  }
+
+  static constexpr size_t min_log_scan = 256;
+
+  void flush_if_log_large() const {
+    if (m_log.size() > max_log_scan()) {
+      flush();
+    }
+  }
+
+  template <typename K>
+  bool log_contains(const K &val) const {
+    return std::any_of(m_log.begin(), m_log.end(), [this, &val](const auto &v) {
+      return equivalent(v, val);
+    });
+  }
+
+  template <typename K>
+  bool equivalent(const value_type &a, const K &b) const {
+    return !m_compare(a, b) && !m_compare(b, a);
+  }
+
+  auto equivalent() const {
+    return [this](const value_type &a, const value_type &b) {
+      return equivalent(a, b);
+    };
+  }
+
+  // Reads flush pending inserts, so both vectors change under const
+  mutable std::vector<Value> m_sorted;
+  mutable std::vector<Value> m_log;
+  Compare                    m_compare;
+};
+
+}  // namespace ygm::container::detail
@@ -17,38 +17,53 @@
 #include <ygm/container/detail/base_count.hpp>
 #include <ygm/container/detail/base_iteration.hpp>
 #include <ygm/container/detail/base_misc.hpp>
+#include <ygm/container/detail/flat_hash_map.hpp>
 #include <ygm/container/detail/hash_partitioner.hpp>
+#include <ygm/container/detail/lookup_key.hpp>
 
 namespace ygm::container {
 
-template <typename Key, typename Value>
+template <typename Key, typename Value, typename Storage = node_storage>
 class map
-    : public detail::base_async_insert_key_value<map<Key, Value>,
+    : public detail::base_async_insert_key_value<map<Key, Value, Storage>,
                                                  std::tuple<Key, Value>>,
-      public detail::base_async_insert_or_assign<map<Key, Value>,
+      public detail::base_async_insert_or_assign<map<Key, Value, Storage>,
                                                  std::tuple<Key, Value>>,
-      public detail::base_misc<map<Key, Value>, std::tuple<Key, Value>>,
-      public detail::base_count<map<Key, Value>, std::tuple<Key, Value>>,
-      public detail::base_async_reduce<map<Key, Value>, std::tuple<Key, Value>>,
-      public detail::base_async_erase_key<map<Key, Value>,
+      public detail::base_misc<map<Key, Value, Storage>,
+                               std::tuple<Key, Value>>,
+      public detail::base_count<map<Key, Value, Storage>,
+                                std::tuple<Key, Value>>,
+      public detail::base_async_reduce<map<Key, Value, Storage>,
+                                       std::tuple<Key, Value>>,
+      public detail::base_async_erase_key<map<Key, Value, Storage>,
                                           std::tuple<Key, Value>>,
-      public detail::base_async_erase_key_value<map<Key, Value>,
+      public detail::base_async_erase_key_value<map<Key, Value, Storage>,
                                                 std::tuple<Key, Value>>,
-      public detail::base_batch_erase_key_value<map<Key, Value>,
+      public detail::base_batch_erase_key_value<map<Key, Value, Storage>,
                                                 std::tuple<Key, Value>>,
-      public detail::base_async_visit<map<Key, Value>, std::tuple<Key, Value>>,
-      public detail::base_iteration_key_value<map<Key, Value>,
+      public detail::base_async_visit<map<Key, Value, Storage>,
+                                      std::tuple<Key, Value>>,
+      public detail::base_iteration_key_value<map<Key, Value, Storage>,
                                               std::tuple<Key, Value>> {
-  friend class detail::base_misc<map<Key, Value>, std::tuple<Key, Value>>;
+  friend class detail::base_misc<map<Key, Value, Storage>,
+                                 std::tuple<Key, Value>>;
 
  public:
-  using self_type      = map<Key, Value>;
+  using self_type      = map<Key, Value, Storage>;
   using mapped_type    = Value;
   using ptr_type       = typename ygm::ygm_ptr<self_type>;
   using key_type       = Key;
   using size_type      = size_t;
   using for_all_args   = std::tuple<Key, Value>;
   using container_type = ygm::container::map_tag;
+  using storage_type   = Storage;
+  using hasher         = detail::lookup_hash<Key>;
+  using key_equal      = detail::lookup_equal<Key>;
+  // Open-addressing table with flat_storage, std::unordered_map otherwise
+  using local_container_type =
+      std::conditional_t<std::is_same_v<Storage, flat_storage>,
+                         detail::flat_hash_map<Key, Value, hasher, key_equal>,
+                         std::unordered_map<Key, Value, hasher, key_equal>>;
 
   map() = delete;
 
@@ -105,11 +120,11 @@ class map
 
   ~map() { m_comm.barrier(); }
 
-  using detail::base_async_erase_key<map<Key, Value>,
+  using detail::base_async_erase_key<map<Key, Value, Storage>,
                                      for_all_args>::async_erase;
-  using detail::base_async_erase_key_value<map<Key, Value>,
+  using detail::base_async_erase_key_value<map<Key, Value, Storage>,
                                            for_all_args>::async_erase;
-  using detail::base_batch_erase_key_value<map<Key, Value>,
+  using detail::base_batch_erase_key_value<map<Key, Value, Storage>,
                                            for_all_args>::erase;
 
   void local_insert(const key_type& key) { local_insert(key, m_default_value); }
@@ -136,10 +151,9 @@ class map
   template <typename ReductionOp>
   void local_reduce(const key_type& key, const mapped_type& value,
                     ReductionOp reducer) {
-    if (m_local_map.count(key) == 0) {
-      m_local_map.insert({key, value});
-    } else {
-      m_local_map[key] = reducer(value, m_local_map[key]);
+    auto [itr, inserted] = m_local_map.try_emplace(key, value);
+    if (!inserted) {
+      itr->second = reducer(value, itr->second);
     }
   }
 
@@ -151,15 +165,18 @@ class map
     return m_local_map.at(key);
   }
 
-  template <typename Function, typename... VisitorArgs>
-  void local_visit(const key_type& key, Function& fn,
+  // Lookups also accept std::string_view for maps keyed by std::string
+  template <typename LookupKey, typename Function, typename... VisitorArgs>
+  void local_visit(const LookupKey& key, Function& fn,
                    const VisitorArgs&... args) {
-    local_insert(key);  // inserts only if missing
+    if (m_local_map.find(key) == m_local_map.end()) {
+      local_insert(key_type(key));
+    }
     local_visit_if_contains(key, fn, args...);
   }
 
-  template <typename Function, typename... VisitorArgs>
-  void local_visit_if_contains(const key_type& key, Function& fn,
+  template <typename LookupKey, typename Function, typename... VisitorArgs>
+  void local_visit_if_contains(const LookupKey& key, Function& fn,
                                const VisitorArgs&... args) {
     ygm::detail::interrupt_mask mask(m_comm);
     auto                        range = m_local_map.equal_range(key);
@@ -180,8 +197,8 @@ class map
     }
   }
 
-  template <typename Function, typename... VisitorArgs>
-  void local_visit_if_contains(const key_type& key, Function& fn,
+  template <typename LookupKey, typename Function, typename... VisitorArgs>
+  void local_visit_if_contains(const LookupKey& key, Function& fn,
                                const VisitorArgs&... args) const {
     ygm::detail::interrupt_mask mask(m_comm);
     auto                        range = m_local_map.equal_range(key);
@@ -242,7 +259,7 @@ class map
   void local_for_all(Function fn) {
     if constexpr (std::is_invocable<decltype(fn), const key_type,
                                     mapped_type&>()) {
-      for (std::pair<const key_type, mapped_type>& kv : m_local_map) {
+      for (auto& kv : m_local_map) {
         fn(kv.first, kv.second);
       }
     } else {
@@ -256,7 +273,7 @@ class map
   void local_for_all(Function fn) const {
     if constexpr (std::is_invocable<decltype(fn), const key_type,
                                     const mapped_type&>()) {
-      for (const std::pair<const key_type, mapped_type>& kv : m_local_map) {
+      for (const auto& kv : m_local_map) {
         fn(kv.first, kv.second);
       }
     } else {
@@ -306,7 +323,8 @@ class map
   //   m_impl.for_all(fn);
   // }
 
-  size_t local_count(const key_type& key) const {
+  template <typename LookupKey>
+  size_t local_count(const LookupKey& key) const {
     return m_local_map.count(key);
   }
 
@@ -333,15 +351,15 @@ class map
   //   return m_impl.topk(k, cfn);
   // }
 
-  detail::hash_partitioner<std::hash<key_type>> partitioner;
+  detail::hash_partitioner<detail::lookup_hash<key_type>> partitioner;
 
  private:
   void local_swap(self_type& other) { m_local_map.swap(other.m_local_map); }
 
-  ygm::comm&                                m_comm;
-  std::unordered_map<key_type, mapped_type> m_local_map;
-  mapped_type                               m_default_value;
-  typename ygm::ygm_ptr<self_type>          pthis;
+  ygm::comm&                       m_comm;
+  local_container_type             m_local_map;
+  mapped_type                      m_default_value;
+  typename ygm::ygm_ptr<self_type> pthis;
 };
 
 template <typename Key, typename Value>
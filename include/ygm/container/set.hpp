@@ -16,32 +16,47 @@
 #include <ygm/container/detail/base_iteration.hpp>
 #include <ygm/container/detail/base_misc.hpp>
 #include <ygm/container/detail/hash_partitioner.hpp>
+#include <ygm/container/detail/lookup_key.hpp>
+#include <ygm/container/detail/sorted_vector_set.hpp>
 
 namespace ygm::container {
 
-template <typename Value>
+template <typename Value, typename Storage = node_storage>
 class multiset
-    : public detail::base_async_insert_value<multiset<Value>,
+    : public detail::base_async_insert_value<multiset<Value, Storage>,
                                              std::tuple<Value>>,
-      public detail::base_async_erase_key<multiset<Value>, std::tuple<Value>>,
-      public detail::base_batch_erase_key<multiset<Value>, std::tuple<Value>>,
-      public detail::base_async_contains<multiset<Value>, std::tuple<Value>>,
-      public detail::base_async_insert_contains<multiset<Value>,
+      public detail::base_async_erase_key<multiset<Value, Storage>,
+                                          std::tuple<Value>>,
+      public detail::base_batch_erase_key<multiset<Value, Storage>,
+                                          std::tuple<Value>>,
+      public detail::base_async_contains<multiset<Value, Storage>,
+                                         std::tuple<Value>>,
+      public detail::base_async_insert_contains<multiset<Value, Storage>,
                                                 std::tuple<Value>>,
-      public detail::base_count<multiset<Value>, std::tuple<Value>>,
-      public detail::base_misc<multiset<Value>, std::tuple<Value>>,
-      public detail::base_iteration_value<multiset<Value>, std::tuple<Value>> {
-  friend class detail::base_misc<multiset<Value>, std::tuple<Value>>;
+      public detail::base_count<multiset<Value, Storage>, std::tuple<Value>>,
+      public detail::base_misc<multiset<Value, Storage>, std::tuple<Value>>,
+      public detail::base_iteration_value<multiset<Value, Storage>,
+                                          std::tuple<Value>> {
+  friend class detail::base_misc<multiset<Value, Storage>, std::tuple<Value>>;
 
  public:
-  using self_type      = multiset<Value>;
+  using self_type      = multiset<Value, Storage>;
   using value_type     = Value;
   using size_type      = size_t;
   using for_all_args   = std::tuple<Value>;
   using container_type = ygm::container::set_tag;
+  using storage_type   = Storage;
+  // Sorted vector with flat_storage, std::multiset otherwise
+  using local_container_type =
+      std::conditional_t<std::is_same_v<Storage, flat_storage>,
+                         detail::sorted_vector_set<Value, true,
+                                                   detail::lookup_less<Value>>,
+                         std::multiset<Value, detail::lookup_less<Value>>>;
 
   multiset(ygm::comm &comm)
-      : m_comm(comm), pthis(this), partitioner(comm, std::hash<value_type>()) {
+      : m_comm(comm),
+        pthis(this),
+        partitioner(comm, detail::lookup_hash<value_type>()) {
     pthis.check(m_comm);
   }
 
@@ -112,13 +127,27 @@ class multiset
     return *this;
   }
 
-  void local_insert(const value_type &val) { m_local_set.insert(val); }
+  void local_insert(const value_type &val) {
+    if constexpr (std::is_same_v<Storage, flat_storage>) {
+      // Once per barrier, lookups may flush the log in between
+      if (!m_flush_registered) {
+        m_flush_registered = true;
+        m_comm.register_pre_barrier_callback([this]() {
+          m_local_set.flush();
+          m_flush_registered = false;
+        });
+      }
+    }
+    m_local_set.insert(val);
+  }
 
   void local_erase(const value_type &val) { m_local_set.erase(val); }
 
   void local_clear() { m_local_set.clear(); }
 
-  size_t local_count(const value_type &val) const {
+  // Also accepts std::string_view for sets of std::string
+  template <typename LookupValue>
+  size_t local_count(const LookupValue &val) const {
     return m_local_set.count(val);
   }
 
@@ -138,37 +167,53 @@ class multiset
 
   void deserialize(const std::string &fname) {}
 
-  detail::hash_partitioner<std::hash<value_type>> partitioner;
+  detail::hash_partitioner<detail::lookup_hash<value_type>> partitioner;
 
  private:
   void local_swap(self_type &other) { m_local_set.swap(other.m_local_set); }
 
   ygm::comm                       &m_comm;
-  std::multiset<value_type>        m_local_set;
+  local_container_type             m_local_set;
+  bool                             m_flush_registered = false;
   typename ygm::ygm_ptr<self_type> pthis;
 };
 
-template <typename Value>
+template <typename Value, typename Storage = node_storage>
 class set
-    : public detail::base_async_insert_value<set<Value>, std::tuple<Value>>,
-      public detail::base_async_erase_key<set<Value>, std::tuple<Value>>,
-      public detail::base_batch_erase_key<set<Value>, std::tuple<Value>>,
-      public detail::base_async_contains<set<Value>, std::tuple<Value>>,
-      public detail::base_async_insert_contains<set<Value>, std::tuple<Value>>,
-      public detail::base_count<set<Value>, std::tuple<Value>>,
-      public detail::base_misc<set<Value>, std::tuple<Value>>,
-      public detail::base_iteration_value<set<Value>, std::tuple<Value>> {
-  friend class detail::base_misc<set<Value>, std::tuple<Value>>;
+    : public detail::base_async_insert_value<set<Value, Storage>,
+                                             std::tuple<Value>>,
+      public detail::base_async_erase_key<set<Value, Storage>,
+                                          std::tuple<Value>>,
+      public detail::base_batch_erase_key<set<Value, Storage>,
+                                          std::tuple<Value>>,
+      public detail::base_async_contains<set<Value, Storage>,
+                                         std::tuple<Value>>,
+      public detail::base_async_insert_contains<set<Value, Storage>,
+                                                std::tuple<Value>>,
+      public detail::base_count<set<Value, Storage>, std::tuple<Value>>,
+      public detail::base_misc<set<Value, Storage>, std::tuple<Value>>,
+      public detail::base_iteration_value<set<Value, Storage>,
+                                          std::tuple<Value>> {
+  friend class detail::base_misc<set<Value, Storage>, std::tuple<Value>>;
 
  public:
-  using self_type      = set<Value>;
+  using self_type      = set<Value, Storage>;
   using value_type     = Value;
   using size_type      = size_t;
   using for_all_args   = std::tuple<Value>;
   using container_type = ygm::container::set_tag;
+  using storage_type   = Storage;
+  // Sorted vector with flat_storage, std::set otherwise
+  using local_container_type =
+      std::conditional_t<std::is_same_v<Storage, flat_storage>,
+                         detail::sorted_vector_set<Value, false,
+                                                   detail::lookup_less<Value>>,
+                         std::set<Value, detail::lookup_less<Value>>>;
 
   set(ygm::comm &comm)
-      : m_comm(comm), pthis(this), partitioner(comm, std::hash<value_type>()) {
+      : m_comm(comm),
+        pthis(this),
+        partitioner(comm, detail::lookup_hash<value_type>()) {
     pthis.check(m_comm);
   }
 
@@ -235,15 +280,29 @@ class set
     return *this;
   }
 
-  using detail::base_batch_erase_key<set<Value>, for_all_args>::erase;
-
-  void local_insert(const value_type &val) { m_local_set.insert(val); }
+  using detail::base_batch_erase_key<set<Value, Storage>, for_all_args>::erase;
+
+  void local_insert(const value_type &val) {
+    if constexpr (std::is_same_v<Storage, flat_storage>) {
+      // Once per barrier, lookups may flush the log in between
+      if (!m_flush_registered) {
+        m_flush_registered = true;
+        m_comm.register_pre_barrier_callback([this]() {
+          m_local_set.flush();
+          m_flush_registered = false;
+        });
+      }
+    }
+    m_local_set.insert(val);
+  }
 
   void local_erase(const value_type &val) { m_local_set.erase(val); }
 
   void local_clear() { m_local_set.clear(); }
 
-  size_t local_count(const value_type &val) const {
+  // Also accepts std::string_view for sets of std::string
+  template <typename LookupValue>
+  size_t local_count(const LookupValue &val) const {
     return m_local_set.count(val);
   }
 
@@ -263,13 +322,14 @@ class set
 
   void deserialize(const std::string &fname) {}
 
-  detail::hash_partitioner<std::hash<value_type>> partitioner;
+  detail::hash_partitioner<detail::lookup_hash<value_type>> partitioner;
 
  private:
   void local_swap(self_type &other) { m_local_set.swap(other.m_local_set); }
 
   ygm::comm                       &m_comm;
-  std::set<value_type>             m_local_set;
+  local_container_type             m_local_set;
+  bool                             m_flush_registered = false;
   typename ygm::ygm_ptr<self_type> pthis;
 };
 
@@ -0,0 +1,131 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <ygm/detail/layout.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Sizes per-destination send buffers from observed traffic.
+ *
+ * Flushed bytes are tallied per destination and folded into a moving average
+ * every epoch (once the whole buffer budget has been flushed).  Each
+ * destination then keeps a small minimum reservation and the rest of the
+ * local or remote budget is split in proportion to rate, so thresholds never
+ * sum past the budget.  Hot destinations flush themselves in large buffers
+ * while cold destinations stop holding a uniform share they do not use.
+ */
+class adaptive_buffer_policy {
+ public:
+  adaptive_buffer_policy(const layout &l, size_t local_budget,
+                         size_t remote_budget)
+      : m_layout(l),
+        m_local_budget(local_budget),
+        m_remote_budget(remote_budget),
+        m_epoch_length(local_budget + remote_budget),
+        m_rate(l.size(), 0.0),
+        m_epoch_bytes(l.size(), 0),
+        m_threshold(l.size()) {
+    for (int dest = 0; dest < l.size(); ++dest) {
+      m_threshold[dest] = uniform_share(dest);
+    }
+  }
+
+  /**
+   * @brief Bytes to reserve when a destination's buffer is first used
+   */
+  size_t reserve_size(int dest) const { return m_threshold[dest]; }
+
+  /**
+   * @brief Buffer size at which a destination is flushed on its own
+   */
+  size_t flush_threshold(int dest) const { return m_threshold[dest]; }
+
+  /**
+   * @brief Records bytes flushed to dest, rebalancing at the end of an epoch
+   */
+  void record_flush(int dest, size_t bytes) {
+    m_epoch_bytes[dest] += bytes;
+    m_epoch_total += bytes;
+    if (m_epoch_total >= m_epoch_length) {
+      rebalance();
+    }
+  }
+
+  size_t rebalance_count() const { return m_rebalance_count; }
+
+  size_t max_threshold() const {
+    return *std::max_element(m_threshold.begin(), m_threshold.end());
+  }
+
+  size_t min_threshold() const {
+    return *std::min_element(m_threshold.begin(), m_threshold.end());
+  }
+
+ private:
+  // Smallest reservation kept for a destination that has gone cold
+  static constexpr size_t min_reserve = 4 * 1024;
+
+  void rebalance() {
+    double local_sum(0), remote_sum(0);
+    size_t local_count(0), remote_count(0);
+    for (int dest = 0; dest < m_layout.size(); ++dest) {
+      m_rate[dest] = 0.5 * m_rate[dest] + 0.5 * m_epoch_bytes[dest];
+      m_epoch_bytes[dest] = 0;
+      if (m_layout.is_local(dest)) {
+        local_sum += m_rate[dest];
+        ++local_count;
+      } else {
+        remote_sum += m_rate[dest];
+        ++remote_count;
+      }
+    }
+    for (int dest = 0; dest < m_layout.size(); ++dest) {
+      bool   local  = m_layout.is_local(dest);
+      double sum    = local ? local_sum : remote_sum;
+      size_t budget = local ? m_local_budget : m_remote_budget;
+      size_t count  = local ? local_count : remote_count;
+      size_t floor  = std::min(budget / count, min_reserve);
+      if (sum <= 0) {
+        m_threshold[dest] = budget / count;
+        continue;
+      }
+      // Every destination keeps floor, the rest is split by rate, so the
+      // thresholds of a group sum to at most its budget
+      size_t share =
+          floor + size_t((budget - count * floor) * (m_rate[dest] / sum));
+      // Leave room for other destinations before the global budget is hit
+      m_threshold[dest] = std::min(share, std::max(budget / 2, floor));
+    }
+    m_epoch_total = 0;
+    ++m_rebalance_count;
+  }
+
+  size_t uniform_share(int dest) const {
+    if (m_layout.is_local(dest)) {
+      return m_local_budget / m_layout.local_size();
+    }
+    return m_remote_budget / m_layout.node_size();
+  }
+
+  const layout       &m_layout;
+  size_t              m_local_budget;
+  size_t              m_remote_budget;
+  size_t              m_epoch_length;
+  size_t              m_epoch_total     = 0;
+  size_t              m_rebalance_count = 0;
+  std::vector<double> m_rate;
+  std::vector<size_t> m_epoch_bytes;
+  std::vector<size_t> m_threshold;
+};
+
+}  // namespace detail
+}  // namespace ygm
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <cstddef>
@@ -14,6 +15,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <vector>
+#include <ygm/detail/byte_vector_pool.hpp>
 
 namespace ygm::detail {
 class byte_vector {  
@@ -55,17 +57,11 @@ public:
   byte_vector() : m_data(nullptr), m_size(0), m_capacity(0) {}
 
   byte_vector(size_t set_capacity) : m_size(0) {
-    m_capacity = get_page_aligned_size(set_capacity);
-    // now that the shm_file is the correct size we can memory map to it.
-    m_data = (pointer) mmap(NULL, m_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
-    if (m_data == MAP_FAILED) {
-      std::cerr << strerror(errno) << std::endl;
-      throw std::runtime_error("mmap failed to allocate byte_vector:" + std::string(strerror(errno)));
-    }
+    m_data = byte_vector_pool::instance().allocate(set_capacity, m_capacity);
   }
 
   ~byte_vector() {
-    munmap(m_data, m_capacity);
+    byte_vector_pool::instance().deallocate(m_data, m_capacity);
   }
 
   byte_vector(byte_vector&)        = default;
@@ -95,16 +91,24 @@ public:
    * @param cap The new capacity to reserve, it will be page aligned.
    */
   void reserve(size_t cap) {
-    size_t new_capacity = get_page_aligned_size(cap);
+    byte_vector_pool &pool = byte_vector_pool::instance();
     if(m_data == nullptr) {
-      m_capacity = new_capacity;
-      // now that the shm_file is the correct size we can memory map to it.
-      m_data = (pointer) mmap(NULL, m_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
-      if (m_data == MAP_FAILED) {
-        throw std::runtime_error("mmap failed to initialize empty byte_vector:" + std::string(strerror(errno)));
-      }
+      m_data = pool.allocate(cap, m_capacity);
       return;
     }
+    // Never shrink, live bytes must survive a reserve
+    if(cap <= m_capacity) return;
+    if(pool.enabled()) {
+      // Swap in a pooled block rather than remapping
+      size_t  allocated;
+      pointer temp = pool.allocate(cap, allocated);
+      memcpy(temp, m_data, m_size);
+      pool.deallocate(m_data, m_capacity);
+      m_data     = temp;
+      m_capacity = allocated;
+      return;
+    }
+    size_t new_capacity = get_page_aligned_size(cap);
     // if max osx handler
     #if __APPLE__
       pointer temp = (pointer) mmap(NULL, new_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
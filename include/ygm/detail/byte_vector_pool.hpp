@@ -0,0 +1,207 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ygm::detail {
+
+/**
+ * @brief Process-wide cache of page-aligned mappings backing byte_vector.
+ *
+ * While enabled, capacities are rounded up to power-of-two size classes and
+ * released blocks are kept for reuse instead of being unmapped, up to a
+ * limit on cached bytes.  Blocks of at least a huge page can be backed by
+ * MAP_HUGETLB (falling back to regular pages) or marked for transparent huge
+ * pages.  While disabled, every block is a fresh mmap as before.
+ */
+class byte_vector_pool {
+ public:
+  enum class huge_page_type { NONE, THP, HUGETLB };
+
+  static constexpr size_t huge_page_size = size_t(2) * 1024 * 1024;
+  // Larger blocks (e.g. receive buffers) are mapped directly
+  static constexpr size_t max_class_size = size_t(256) * 1024 * 1024;
+
+  static byte_vector_pool &instance() {
+    // Never destroyed, so byte_vectors in static storage can still release
+    static byte_vector_pool *pool = new byte_vector_pool();
+    return *pool;
+  }
+
+  void configure(bool enabled, size_t max_cached_bytes,
+                 huge_page_type huge_pages) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled          = enabled;
+    m_max_cached_bytes = max_cached_bytes;
+    m_huge_pages       = huge_pages;
+    if (!m_enabled) {
+      trim_locked();
+    }
+  }
+
+  bool enabled() const { return m_enabled; }
+
+  /**
+   * @brief Capacity of the block that allocate() returns for bytes
+   */
+  size_t capacity_for(size_t bytes) const {
+    size_t page_aligned = page_aligned_size(bytes);
+    if (!m_enabled || page_aligned > max_class_size) {
+      return page_aligned;
+    }
+    size_t capacity = m_page_size;
+    while (capacity < page_aligned) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  /**
+   * @brief Returns a block of capacity_for(bytes) bytes
+   */
+  std::byte *allocate(size_t bytes, size_t &capacity) {
+    capacity = capacity_for(bytes);
+    if (m_enabled) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::vector<std::byte *>   *free_list = find_free_list(capacity);
+      if (free_list && !free_list->empty()) {
+        std::byte *to_return = free_list->back();
+        free_list->pop_back();
+        m_cached_bytes -= capacity;
+        ++m_hits;
+        return to_return;
+      }
+      ++m_misses;
+    }
+    return map(capacity);
+  }
+
+  void deallocate(std::byte *data, size_t capacity) {
+    if (data == nullptr) {
+      return;
+    }
+    if (m_enabled) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::vector<std::byte *>   *free_list = find_free_list(capacity);
+      if (free_list && m_cached_bytes + capacity <= m_max_cached_bytes) {
+        free_list->push_back(data);
+        m_cached_bytes += capacity;
+        return;
+      }
+    }
+    munmap(data, capacity);
+  }
+
+  /**
+   * @brief Unmaps every cached block
+   */
+  void trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    trim_locked();
+  }
+
+  size_t hits() const { return m_hits; }
+  size_t misses() const { return m_misses; }
+  size_t cached_bytes() const { return m_cached_bytes; }
+  size_t huge_page_fallbacks() const { return m_huge_page_fallbacks; }
+
+  void reset_stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hits                = 0;
+    m_misses              = 0;
+    m_huge_page_fallbacks = 0;
+  }
+
+ private:
+  byte_vector_pool() : m_page_size(getpagesize()) {
+    for (size_t c = m_page_size; c <= max_class_size; c *= 2) {
+      m_free_lists.emplace_back();
+    }
+  }
+
+  size_t page_aligned_size(size_t bytes) const {
+    return (bytes + m_page_size - 1) / m_page_size * m_page_size;
+  }
+
+  /**
+   * @brief Free list of a size class, or nullptr if capacity is not one
+   */
+  std::vector<std::byte *> *find_free_list(size_t capacity) {
+    size_t c = m_page_size;
+    for (auto &free_list : m_free_lists) {
+      if (c == capacity) {
+        return &free_list;
+      }
+      c *= 2;
+    }
+    return nullptr;
+  }
+
+  std::byte *map(size_t capacity) {
+    bool  huge   = capacity >= huge_page_size;
+    void *mapped = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge && m_huge_pages == huge_page_type::HUGETLB &&
+        capacity % huge_page_size == 0) {
+      mapped = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (mapped == MAP_FAILED) {
+        // No huge pages reserved, use transparent huge pages instead
+        ++m_huge_page_fallbacks;
+      }
+    }
+#endif
+    if (mapped == MAP_FAILED) {
+      mapped = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mapped == MAP_FAILED) {
+        throw std::runtime_error("mmap failed to allocate byte_vector:" +
+                                 std::string(strerror(errno)));
+      }
+#ifdef MADV_HUGEPAGE
+      if (huge && m_huge_pages != huge_page_type::NONE) {
+        madvise(mapped, capacity, MADV_HUGEPAGE);
+      }
+#endif
+    }
+    return (std::byte *)mapped;
+  }
+
+  void trim_locked() {
+    size_t c = m_page_size;
+    for (auto &free_list : m_free_lists) {
+      for (std::byte *data : free_list) {
+        munmap(data, c);
+      }
+      free_list.clear();
+      c *= 2;
+    }
+    m_cached_bytes = 0;
+  }
+
+  const size_t                          m_page_size;
+  std::mutex                            m_mutex;
+  bool                                  m_enabled          = false;
+  size_t                                m_max_cached_bytes = 0;
+  huge_page_type                        m_huge_pages = huge_page_type::NONE;
+  std::vector<std::vector<std::byte *>> m_free_lists;
+  size_t                                m_cached_bytes        = 0;
+  size_t                                m_hits                = 0;
+  size_t                                m_misses              = 0;
+  std::atomic<size_t>                   m_huge_page_fallbacks = 0;
+};
+
+}  // namespace ygm::detail
@@ -21,13 +21,69 @@ struct comm::mpi_isend_request {
   MPI_Request                             request;
 };
 
+struct comm::completed_irecv {
+  std::shared_ptr<ygm::detail::byte_vector> buffer;
+  int                                       source;
+  size_t                                    size;
+  int                                       tag;
+};
+
+struct comm::queued_isend {
+  int                                       dest;
+  int                                       tag;
+  std::shared_ptr<ygm::detail::byte_vector> buffer;
+};
+
 struct comm::header_t {
   uint32_t message_size;
   int32_t  dest;
 };
 
+/**
+ * @brief Per-thread packing buffers used when YGM_COMM_THREAD_SAFE_ASYNC is
+ * set.  Only touched by the owning thread until coalesced under the async lock.
+ */
+struct comm::thread_send_buffers {
+  std::thread::id                       owner;
+  std::vector<ygm::detail::byte_vector> buffers;
+  std::deque<int>                       dests;
+  size_t                                bytes      = 0;
+  uint64_t                              send_count = 0;
+  std::vector<size_t>                   async_counts;
+  std::vector<int>                      async_dests;
+};
+
+/**
+ * @brief Recursive lock over comm state, a no-op unless
+ * YGM_COMM_THREAD_SAFE_ASYNC is set.
+ */
+class comm::async_lock_guard {
+ public:
+  async_lock_guard(comm *c) : m_comm(c->m_thread_safe_async ? c : nullptr) {
+    if (m_comm) {
+      m_comm->m_async_mutex.lock();
+      if (m_comm->m_async_lock_depth++ == 0) {
+        m_comm->m_async_lock_owner = std::this_thread::get_id();
+      }
+    }
+  }
+
+  ~async_lock_guard() {
+    if (m_comm) {
+      if (--m_comm->m_async_lock_depth == 0) {
+        m_comm->m_async_lock_owner = std::thread::id();
+      }
+      m_comm->m_async_mutex.unlock();
+    }
+  }
+
+ private:
+  comm *m_comm;
+};
+
 inline comm::comm(int *argc, char ***argv)
-    : pimpl_if(std::make_shared<detail::mpi_init_finalize>(argc, argv)),
+    : pimpl_if(std::make_shared<detail::mpi_init_finalize>(
+          argc, argv, detail::comm_environment::required_thread_level())),
       m_layout(MPI_COMM_WORLD),
       m_router(m_layout, config.routing) {
   // pimpl_if = std::make_shared<detail::mpi_init_finalize>(argc, argv);
@@ -46,19 +102,99 @@ inline comm::comm(MPI_Comm mcomm)
 }
 
 inline void comm::comm_setup(MPI_Comm c) {
+  detail::byte_vector_pool::instance().configure(
+      config.buffer_pool, config.buffer_pool_max_size, config.huge_pages);
+
   YGM_ASSERT_MPI(MPI_Comm_dup(c, &m_comm_async));
   YGM_ASSERT_MPI(MPI_Comm_dup(c, &m_comm_barrier));
+  m_count_reducer =
+      std::make_unique<detail::hierarchical_count_reducer>(m_comm_barrier);
   YGM_ASSERT_MPI(MPI_Comm_dup(c, &m_comm_other));
 
   m_vec_send_buffers.resize(m_layout.size());
+  m_send_dest_queued.resize(m_layout.size(), false);
+  m_transport_backlog.resize(m_layout.size());
+  m_transport_bypass.resize(m_layout.size(), false);
+  m_vec_urgent_buffers.resize(m_layout.size());
+
+  static std::atomic<uint64_t> instance_counter = 0;
+  m_instance_id = ++instance_counter;
+
+  if (config.thread_safe_async) {
+    int provided(0);
+    YGM_ASSERT_MPI(MPI_Query_thread(&provided));
+    if (provided < MPI_THREAD_SERIALIZED) {
+      throw std::runtime_error(
+          "YGM::COMM ERROR: YGM_COMM_THREAD_SAFE_ASYNC requires at least "
+          "MPI_THREAD_SERIALIZED");
+    }
+    m_thread_safe_async = true;
+  }
 
   if (config.welcome) {
     welcome(std::cout);
   }
 
-  for (size_t i = 0; i < config.num_irecvs; ++i) {
-    std::shared_ptr<ygm::detail::byte_vector> recv_buffer{new ygm::detail::byte_vector(config.irecv_size)};
-    post_new_irecv(recv_buffer);
+  if (config.probe_recv) {
+    m_recv_buffer_pool = detail::recv_buffer_pool(config.num_irecvs);
+  } else {
+    for (size_t i = 0; i < config.num_irecvs; ++i) {
+      std::shared_ptr<ygm::detail::byte_vector> recv_buffer{new ygm::detail::byte_vector(config.irecv_size)};
+      if (config.persistent_recv) {
+        MPI_Request request;
+        YGM_ASSERT_MPI(MPI_Recv_init(recv_buffer->data(), config.irecv_size,
+                                     MPI_BYTE, MPI_ANY_SOURCE, MPI_ANY_TAG,
+                                     m_comm_async, &request));
+        m_persistent_recvs.emplace(recv_buffer.get(), request);
+      }
+      post_new_irecv(recv_buffer);
+    }
+  }
+
+  if (config.shm_transport) {
+    m_shm = std::make_unique<detail::shm_transport>(c, m_layout,
+                                                    config.shm_ring_size);
+  }
+
+  if (config.rma_transport) {
+    m_rma = std::make_unique<detail::rma_transport>(c, config.rma_slots,
+                                                    config.rma_slot_size);
+  }
+
+  if (config.traffic_stats != detail::traffic_stats_type::NONE) {
+    stats.enable_traffic(size());
+  }
+
+  if (config.profile_handlers) {
+    stats.enable_handler_profile();
+  }
+
+  if (!config.trace_file.empty()) {
+    m_tracer = std::make_unique<detail::event_tracer>(config.trace_events);
+  }
+
+  if (config.max_buffer_age_us > 0) {
+    m_send_buffer_start_times.resize(size());
+  }
+
+  if (config.adaptive_buffers) {
+    m_buffer_policy = std::make_unique<detail::adaptive_buffer_policy>(
+        m_layout, config.local_buffer_size, config.remote_buffer_size);
+  }
+
+  m_pack_options.compact = config.archive != detail::archive_type::DEFAULT;
+  if (config.archive == detail::archive_type::DICTIONARY &&
+      config.routing == detail::routing_type::NONE) {
+    m_send_dictionaries.resize(size());
+  }
+
+  if (config.aggregate_handlers &&
+      config.routing == detail::routing_type::NONE) {
+    m_handler_runs = std::make_unique<detail::handler_run_encoder>(size());
+  }
+
+  if (config.progress_thread) {
+    progress_thread_start();
   }
 }
 
@@ -100,8 +236,13 @@ inline void comm::welcome(std::ostream &os) {
   }
 }
 
-inline void comm::stats_reset() { stats.reset(); }
+inline void comm::stats_reset() {
+  stats.reset();
+  detail::byte_vector_pool::instance().reset_stats();
+}
 inline void comm::stats_print(const std::string &name, std::ostream &os) {
+  size_t compress_raw_bytes = all_reduce_sum(stats.get_compress_raw_bytes());
+  size_t compress_bytes     = all_reduce_sum(stats.get_compress_bytes());
   std::stringstream sstr;
   sstr << "============== STATS =================\n"
        << "NAME                     = " << name << "\n"
@@ -112,7 +253,66 @@ inline void comm::stats_print(const std::string &name, std::ostream &os) {
        << all_reduce_sum(stats.get_isend_count()) << "\n"
        << "GLOBAL_ISEND_BYTES       = "
        << all_reduce_sum(stats.get_isend_bytes()) << "\n"
-       << "MAX_WAITSOME_ISEND_IRECV = "
+       << "GLOBAL_SHM_SEND_COUNT    = "
+       << all_reduce_sum(stats.get_shm_send_count()) << "\n"
+       << "GLOBAL_SHM_SEND_BYTES    = "
+       << all_reduce_sum(stats.get_shm_send_bytes()) << "\n"
+       << "GLOBAL_RMA_SEND_COUNT    = "
+       << all_reduce_sum(stats.get_rma_send_count()) << "\n"
+       << "GLOBAL_RMA_SEND_BYTES    = "
+       << all_reduce_sum(stats.get_rma_send_bytes()) << "\n"
+       << "GLOBAL_COMPRESS_COUNT    = "
+       << all_reduce_sum(stats.get_compress_count()) << "\n"
+       << "GLOBAL_COMPRESS_RATIO    = "
+       << (compress_bytes > 0 ? double(compress_raw_bytes) / compress_bytes
+                              : 1.0)
+       << "\n"
+       << "MAX_COMPRESS_TIME        = "
+       << all_reduce_max(stats.get_compress_time()) << "\n"
+       << "MAX_DECOMPRESS_TIME      = "
+       << all_reduce_max(stats.get_decompress_time()) << "\n"
+       << "GLOBAL_ADAPTIVE_FLUSHES  = "
+       << all_reduce_sum(stats.get_adaptive_flush_count()) << "\n";
+  if (config.buffer_pool) {
+    const detail::byte_vector_pool &pool = detail::byte_vector_pool::instance();
+    sstr << "GLOBAL_POOL_HITS         = " << all_reduce_sum(pool.hits()) << "\n"
+         << "GLOBAL_POOL_MISSES       = " << all_reduce_sum(pool.misses())
+         << "\n"
+         << "MAX_POOL_CACHED_MB       = "
+         << all_reduce_max(pool.cached_bytes()) / (1024 * 1024) << "\n";
+  }
+  if (config.huge_pages == detail::huge_page_type::HUGETLB) {
+    sstr << "GLOBAL_HUGETLB_FALLBACKS = "
+         << all_reduce_sum(
+                detail::byte_vector_pool::instance().huge_page_fallbacks())
+         << "\n";
+  }
+  sstr << "GLOBAL_URGENT_FLUSHES    = "
+       << all_reduce_sum(stats.get_urgent_flush_count()) << "\n";
+  if (!m_send_buffer_start_times.empty()) {
+    sstr << "GLOBAL_AGE_FLUSHES       = "
+         << all_reduce_sum(stats.get_age_flush_count()) << "\n"
+         << "MAX_BUFFER_AGE_US        = "
+         << all_reduce_max(stats.get_max_buffer_age_us()) << "\n";
+  }
+  // Gated on config, as combiners are only registered on ranks that use them
+  if (config.route_combine && config.routing != detail::routing_type::NONE) {
+    sstr << "GLOBAL_ROUTE_COMBINED    = "
+         << all_reduce_sum(stats.get_route_combine_count()) << "\n";
+  }
+  if (m_handler_runs) {
+    sstr << "GLOBAL_AGGREGATED_ASYNCS = "
+         << all_reduce_sum(m_handler_runs->aggregated_count()) << "\n";
+  }
+  if (m_buffer_policy) {
+    sstr << "MAX_ADAPTIVE_REBALANCES  = "
+         << all_reduce_max(m_buffer_policy->rebalance_count()) << "\n"
+         << "MAX_BUFFER_THRESHOLD_KB  = "
+         << all_reduce_max(m_buffer_policy->max_threshold()) / 1024 << "\n"
+         << "MIN_BUFFER_THRESHOLD_KB  = "
+         << all_reduce_min(m_buffer_policy->min_threshold()) / 1024 << "\n";
+  }
+  sstr << "MAX_WAITSOME_ISEND_IRECV = "
        << all_reduce_max(stats.get_waitsome_isend_irecv_time()) << "\n"
        << "MAX_WAITSOME_IALLREDUCE  = "
        << all_reduce_max(stats.get_waitsome_iallreduce_time()) << "\n"
@@ -122,11 +322,207 @@ inline void comm::stats_print(const std::string &name, std::ostream &os) {
   if (rank0()) {
     os << sstr.str() << std::endl;
   }
+
+  if (stats.handler_profile_enabled()) {
+    stats_print_handler_profile(os);
+  }
+
+  if (stats.traffic_enabled()) {
+    stats_print_traffic(os);
+  }
+}
+
+/**
+ * @brief Prints per-handler call counts, archive bytes consumed and wall time
+ * summed over all ranks, most expensive handler first.  Handler time includes
+ * any nested handlers run while it was executing.  Collective; only rank 0
+ * writes to os.
+ */
+inline void comm::stats_print_handler_profile(std::ostream &os) {
+  size_t              num_lids = m_lambda_map.size();
+  std::vector<size_t> calls(stats.get_handler_calls());
+  std::vector<size_t> bytes(stats.get_handler_bytes());
+  std::vector<double> times(stats.get_handler_times());
+  calls.resize(num_lids, 0);
+  bytes.resize(num_lids, 0);
+  times.resize(num_lids, 0.0);
+  std::vector<size_t> global_calls(num_lids);
+  std::vector<size_t> global_bytes(num_lids);
+  std::vector<double> global_times(num_lids);
+  YGM_ASSERT_MPI(MPI_Reduce(calls.data(), global_calls.data(), num_lids,
+                            detail::mpi_typeof(size_t()), MPI_SUM, 0,
+                            m_comm_other));
+  YGM_ASSERT_MPI(MPI_Reduce(bytes.data(), global_bytes.data(), num_lids,
+                            detail::mpi_typeof(size_t()), MPI_SUM, 0,
+                            m_comm_other));
+  YGM_ASSERT_MPI(MPI_Reduce(times.data(), global_times.data(), num_lids,
+                            MPI_DOUBLE, MPI_SUM, 0, m_comm_other));
+  if (!rank0()) {
+    return;
+  }
+
+  std::vector<size_t> order;
+  for (size_t lid = 0; lid < num_lids; ++lid) {
+    if (global_calls[lid] > 0) {
+      order.push_back(lid);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&global_times](size_t a, size_t b) {
+    return global_times[a] > global_times[b];
+  });
+
+  std::stringstream sstr;
+  sstr << "========== HANDLER PROFILE ===========\n"
+       << "LID, CALLS, BYTES, TIME, NAME\n";
+  for (size_t lid : order) {
+    sstr << lid << ", " << global_calls[lid] << ", " << global_bytes[lid]
+         << ", " << global_times[lid] << ", " << m_lambda_map.name(lid)
+         << "\n";
+  }
+  sstr << "======================================";
+  os << sstr.str() << std::endl;
+}
+
+/**
+ * @brief Prints the flush size, handler time and buffer age histograms
+ * followed by rank-by-rank and node-by-node traffic matrices, as CSV or JSON
+ * depending on YGM_COMM_TRAFFIC_STATS.  Collective; only rank 0 writes to os.
+ */
+inline void comm::stats_print_traffic(std::ostream &os) {
+  auto reduce_histogram = [this](const detail::log2_histogram &h) {
+    std::array<uint64_t, detail::log2_histogram::num_buckets> global{};
+    YGM_ASSERT_MPI(MPI_Reduce(h.counts().data(), global.data(), global.size(),
+                              MPI_UINT64_T, MPI_SUM, 0, m_comm_other));
+    return global;
+  };
+  auto gather_matrix = [this](const std::vector<uint64_t> &row) {
+    std::vector<uint64_t> matrix(rank0() ? row.size() * size() : 0);
+    YGM_ASSERT_MPI(MPI_Gather(row.data(), row.size(), MPI_UINT64_T,
+                              matrix.data(), row.size(), MPI_UINT64_T, 0,
+                              m_comm_other));
+    return matrix;
+  };
+
+  auto flush_sizes   = reduce_histogram(stats.get_flush_size_histogram());
+  auto handler_times = reduce_histogram(stats.get_handler_time_ns_histogram());
+  auto buffer_ages   = reduce_histogram(stats.get_buffer_age_us_histogram());
+  std::vector<std::pair<std::string, std::vector<uint64_t>>> matrices;
+  matrices.emplace_back("async_count",
+                        gather_matrix(stats.get_dest_async_count()));
+  matrices.emplace_back("flush_count",
+                        gather_matrix(stats.get_dest_flush_count()));
+  matrices.emplace_back("flush_bytes",
+                        gather_matrix(stats.get_dest_flush_bytes()));
+  matrices.emplace_back("route_count",
+                        gather_matrix(stats.get_dest_route_count()));
+  if (!rank0()) {
+    return;
+  }
+
+  int                   num_nodes = m_layout.node_size();
+  std::vector<uint64_t> node_bytes(num_nodes * num_nodes, 0);
+  for (int src = 0; src < size(); ++src) {
+    for (int dest = 0; dest < size(); ++dest) {
+      node_bytes[m_layout.node_id(src) * num_nodes + m_layout.node_id(dest)] +=
+          matrices[2].second[src * size() + dest];
+    }
+  }
+
+  auto bucket_range = [](size_t b) {
+    return std::make_pair(b == 0 ? 0 : uint64_t(1) << (b - 1),
+                          b == 0 ? 1 : uint64_t(1) << b);
+  };
+
+  if (config.traffic_stats == detail::traffic_stats_type::JSON) {
+    auto write_matrix = [&os](const std::vector<uint64_t> &m, int n) {
+      os << "[";
+      for (int i = 0; i < n; ++i) {
+        os << (i > 0 ? "," : "") << "[";
+        for (int j = 0; j < n; ++j) {
+          os << (j > 0 ? "," : "") << m[i * n + j];
+        }
+        os << "]";
+      }
+      os << "]";
+    };
+    auto write_histogram = [&os, &bucket_range](const auto &h) {
+      os << "[";
+      bool first = true;
+      for (size_t b = 0; b < h.size(); ++b) {
+        if (h[b] > 0) {
+          auto range = bucket_range(b);
+          os << (first ? "" : ",") << "{\"min\":" << range.first
+             << ",\"max\":" << range.second << ",\"count\":" << h[b] << "}";
+          first = false;
+        }
+      }
+      os << "]";
+    };
+    os << "{\"ranks\":" << size() << ",\"nodes\":" << num_nodes;
+    for (const auto &name_matrix : matrices) {
+      os << ",\"" << name_matrix.first << "\":";
+      write_matrix(name_matrix.second, size());
+    }
+    os << ",\"node_flush_bytes\":";
+    write_matrix(node_bytes, num_nodes);
+    os << ",\"flush_size_histogram\":";
+    write_histogram(flush_sizes);
+    os << ",\"handler_time_ns_histogram\":";
+    write_histogram(handler_times);
+    os << ",\"buffer_age_us_histogram\":";
+    write_histogram(buffer_ages);
+    os << "}" << std::endl;
+  } else {
+    auto write_histogram = [&os, &bucket_range](const std::string &name,
+                                                const auto        &h) {
+      for (size_t b = 0; b < h.size(); ++b) {
+        if (h[b] > 0) {
+          auto range = bucket_range(b);
+          os << name << "," << range.first << "," << range.second << ","
+             << h[b] << "\n";
+        }
+      }
+    };
+    os << "histogram,min,max,count\n";
+    write_histogram("flush_size", flush_sizes);
+    write_histogram("handler_time_ns", handler_times);
+    write_histogram("buffer_age_us", buffer_ages);
+    os << "matrix,src";
+    for (int dest = 0; dest < size(); ++dest) {
+      os << "," << dest;
+    }
+    os << "\n";
+    auto write_rows = [&os](const std::string &name,
+                            const std::vector<uint64_t> &m, int n) {
+      for (int i = 0; i < n; ++i) {
+        os << name << "," << i;
+        for (int j = 0; j < n; ++j) {
+          os << "," << m[i * n + j];
+        }
+        os << "\n";
+      }
+    };
+    for (const auto &name_matrix : matrices) {
+      write_rows(name_matrix.first, name_matrix.second, size());
+    }
+    write_rows("node_flush_bytes", node_bytes, num_nodes);
+    os << std::flush;
+  }
 }
 
 inline comm::~comm() {
   barrier();
 
+  progress_thread_stop();
+  m_shm.reset();
+  m_rma.reset();
+
+  if (m_tracer) {
+    std::ofstream ofs(config.trace_file + "." + std::to_string(rank()) +
+                      ".json");
+    m_tracer->write_chrome_trace(ofs, rank());
+  }
+
   YGM_ASSERT_RELEASE(MPI_Barrier(m_comm_async) == MPI_SUCCESS);
 
   YGM_ASSERT_RELEASE(m_send_queue.empty());
@@ -134,13 +530,26 @@ inline comm::~comm() {
   YGM_ASSERT_RELEASE(m_send_local_buffer_bytes == 0);
   YGM_ASSERT_RELEASE(m_send_remote_dest_queue.empty());
   YGM_ASSERT_RELEASE(m_send_remote_buffer_bytes == 0);
+  YGM_ASSERT_RELEASE(m_urgent_buffer_bytes == 0);
   YGM_ASSERT_RELEASE(m_pending_isend_bytes == 0);
 
   for (size_t i = 0; i < m_recv_queue.size(); ++i) {
     YGM_ASSERT_RELEASE(MPI_Cancel(&(m_recv_queue[i].request)) == MPI_SUCCESS);
   }
+  if (!m_persistent_recvs.empty()) {
+    // Persistent requests must be inactive before they are freed
+    for (auto &recv_req : m_recv_queue) {
+      YGM_ASSERT_RELEASE(MPI_Wait(&(recv_req.request), MPI_STATUS_IGNORE) ==
+                         MPI_SUCCESS);
+    }
+    for (auto &buffer_request : m_persistent_recvs) {
+      YGM_ASSERT_RELEASE(MPI_Request_free(&buffer_request.second) ==
+                         MPI_SUCCESS);
+    }
+  }
   YGM_ASSERT_RELEASE(MPI_Barrier(m_comm_async) == MPI_SUCCESS);
   YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm_async) == MPI_SUCCESS);
+  m_count_reducer.reset();
   YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm_barrier) == MPI_SUCCESS);
   YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm_other) == MPI_SUCCESS);
 
@@ -152,7 +561,16 @@ inline void comm::async(int dest, AsyncFunction fn, const SendArgs &...args) {
   YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(AsyncFunction, "ygm::comm::async()");
 
   YGM_ASSERT_RELEASE(dest < m_layout.size());
+
+  if (m_thread_safe_async && !holds_async_lock()) {
+    async_thread_buffered(dest, fn, std::forward<const SendArgs>(args)...);
+    return;
+  }
+  async_lock_guard lock(this);
   stats.async(dest);
+  if (m_tracer) {
+    m_tracer->instant(detail::event_tracer::event_type::async, dest);
+  }
 
   check_if_production_halt_required();
   m_send_count++;
@@ -169,15 +587,8 @@ inline void comm::async(int dest, AsyncFunction fn, const SendArgs &...args) {
   //
   // add data to the to dest buffer
   if (m_vec_send_buffers[next_dest].empty()) {
-    if (local) {
-      m_send_local_dest_queue.push_back(next_dest);
-      m_vec_send_buffers[next_dest].reserve(config.local_buffer_size /
-                                            m_layout.local_size());
-    } else {
-      m_send_remote_dest_queue.push_back(next_dest);
-      m_vec_send_buffers[next_dest].reserve(config.remote_buffer_size /
-                                            m_layout.node_size());
-    }
+    queue_send_dest(next_dest);
+    m_vec_send_buffers[next_dest].reserve(send_buffer_reserve_size(next_dest));
   }
 
   // // Add header without message size
@@ -191,8 +602,15 @@ inline void comm::async(int dest, AsyncFunction fn, const SendArgs &...args) {
     }
   }
 
-  uint32_t bytes = pack_lambda(m_vec_send_buffers[next_dest], fn,
-                               std::forward<const SendArgs>(args)...);
+  size_t   message_offset = m_vec_send_buffers[next_dest].size();
+  uint32_t bytes          = pack_lambda(
+      m_vec_send_buffers[next_dest],
+      m_send_dictionaries.empty() ? nullptr : &m_send_dictionaries[next_dest],
+      fn, std::forward<const SendArgs>(args)...);
+  if (m_handler_runs) {
+    bytes += m_handler_runs->append(m_vec_send_buffers[next_dest], next_dest,
+                                    message_offset);
+  }
   if (local) {
     m_send_local_buffer_bytes += bytes;
   } else {
@@ -208,13 +626,76 @@ inline void comm::async(int dest, AsyncFunction fn, const SendArgs &...args) {
 
   //
   // Check if send buffer capacity has been exceeded
+  flush_if_over_threshold(next_dest);
   flush_to_capacity();
+  flush_expired_buffers();
+}
+
+template <typename AsyncFunction, typename... SendArgs>
+inline void comm::async_urgent(int dest, AsyncFunction fn,
+                               const SendArgs &...args) {
+  YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(AsyncFunction, "ygm::comm::async_urgent()");
+
+  YGM_ASSERT_RELEASE(dest < m_layout.size());
+
+  async_lock_guard lock(this);
+  stats.async(dest);
+  m_send_count++;
+
+  int next_dest = dest;
+  if (config.routing != detail::routing_type::NONE) {
+    next_dest = m_router.next_hop(dest);
+  }
+  ygm::detail::byte_vector &send_buff = urgent_buffer(next_dest);
+
+  size_t header_bytes = 0;
+  if (config.routing != detail::routing_type::NONE) {
+    header_bytes = pack_header(send_buff, dest, 0);
+  }
+
+  uint32_t bytes = pack_lambda(send_buff, nullptr, fn,
+                               std::forward<const SendArgs>(args)...);
+
+  if (config.routing != detail::routing_type::NONE) {
+    auto iter = send_buff.end();
+    iter -= (header_bytes + bytes);
+    std::memcpy(&*iter, &bytes, sizeof(header_t::dest));
+  }
+  m_urgent_buffer_bytes += header_bytes + bytes;
+}
+
+template <typename... SendArgs, typename AsyncFunction, typename Combiner>
+inline void comm::register_route_combiner(AsyncFunction fn, Combiner combine) {
+  YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(AsyncFunction,
+                                    "ygm::comm::register_route_combiner()");
+  if (!config.route_combine || config.routing == detail::routing_type::NONE) {
+    return;
+  }
+  // Registered once per comm and thread, later calls return here
+  thread_local uint64_t registered_instance_id = 0;
+  if (registered_instance_id == m_instance_id) {
+    return;
+  }
+  async_lock_guard lock(this);
+  uint16_t         lid = register_handler<
+      AsyncFunction,
+      decltype(make_dispatch_lambda<AsyncFunction, SendArgs...>())>();
+  if (lid >= m_route_combiners.size()) {
+    m_route_combiners.resize(lid + 1);
+  }
+  if (!m_route_combiners[lid]) {
+    m_route_combiners[lid] = std::make_unique<
+        detail::typed_route_combiner<AsyncFunction, Combiner, SendArgs...>>(
+        lid, combine);
+  }
+  registered_instance_id = m_instance_id;
 }
 
 template <typename AsyncFunction, typename... SendArgs>
 inline void comm::async_bcast(AsyncFunction fn, const SendArgs &...args) {
   YGM_CHECK_ASYNC_LAMBDA_COMPLIANCE(AsyncFunction, "ygm::comm::async_bcast()");
 
+  async_lock_guard lock(this);
   check_if_production_halt_required();
 
   pack_lambda_broadcast(fn, std::forward<const SendArgs>(args)...);
@@ -251,24 +732,101 @@ inline MPI_Comm comm::get_mpi_comm() const { return m_comm_other; }
  *
  */
 inline void comm::barrier() {
+  async_lock_guard lock(this);
+  YGM_ASSERT_RELEASE(!m_split_barrier_active);
   flush_all_local_and_process_incoming();
   std::pair<uint64_t, uint64_t> previous_counts{1, 2};
   std::pair<uint64_t, uint64_t> current_counts{3, 4};
-  while (!(current_counts.first == current_counts.second &&
-           previous_counts == current_counts)) {
+  while (!barrier_counts_terminated(previous_counts, current_counts)) {
     previous_counts = current_counts;
     current_counts  = barrier_reduce_counts();
     if (current_counts.first != current_counts.second) {
       flush_all_local_and_process_incoming();
     }
   }
+  m_last_barrier_counts = current_counts;
   YGM_ASSERT_RELEASE(m_pre_barrier_callbacks.empty());
   YGM_ASSERT_RELEASE(m_send_local_dest_queue.empty());
   YGM_ASSERT_RELEASE(m_send_remote_dest_queue.empty());
+  reset_transport_bypass();
 
   cf_barrier();
 }
 
+/**
+ * @brief Starts a split-phase barrier.  The first round of count reduction is
+ * posted immediately; barrier_test() drives the rest.
+ */
+inline void comm::barrier_begin() {
+  async_lock_guard lock(this);
+  YGM_ASSERT_RELEASE(!m_split_barrier_active);
+  m_split_barrier_active = true;
+  flush_all_local_and_process_incoming();
+  m_split_barrier_previous_counts = {1, 2};
+  m_split_barrier_current_counts  = {3, 4};
+  barrier_reduce_counts_start();
+}
+
+/**
+ * @brief Processes incoming messages and advances the count reduction of a
+ * split-phase barrier without blocking.
+ *
+ * @return True once the barrier has completed
+ */
+inline bool comm::barrier_test() {
+  async_lock_guard lock(this);
+  YGM_ASSERT_RELEASE(m_split_barrier_active);
+  if (!m_count_reducer->test()) {
+    if (local_process_incoming()) {
+      flush_all_local_and_process_incoming();
+    }
+    return false;
+  }
+
+  m_split_barrier_previous_counts = m_split_barrier_current_counts;
+  m_split_barrier_current_counts  = m_count_reducer->result();
+  if (barrier_counts_terminated(m_split_barrier_previous_counts,
+                                m_split_barrier_current_counts)) {
+    // Every rank sees the same counts, so all ranks finish on this round
+    m_last_barrier_counts  = m_split_barrier_current_counts;
+    m_split_barrier_active = false;
+    YGM_ASSERT_RELEASE(m_pre_barrier_callbacks.empty());
+    YGM_ASSERT_RELEASE(m_send_local_dest_queue.empty());
+    YGM_ASSERT_RELEASE(m_send_remote_dest_queue.empty());
+    reset_transport_bypass();
+    return true;
+  }
+  if (m_split_barrier_current_counts.first !=
+      m_split_barrier_current_counts.second) {
+    flush_all_local_and_process_incoming();
+  }
+  barrier_reduce_counts_start();
+  return false;
+}
+
+/**
+ * @brief Lets destinations that fell back to MPI use the transports again.
+ * Every message has been processed once a barrier completes, so the next
+ * transport record cannot overtake one sent by MPI.
+ */
+inline void comm::reset_transport_bypass() {
+  YGM_ASSERT_RELEASE(m_transport_backlog_dests.empty());
+  std::fill(m_transport_bypass.begin(), m_transport_bypass.end(), false);
+}
+
+/**
+ * @brief True when two consecutive rounds of global counts show that every
+ * message has been processed.  A single balanced round suffices when no rank
+ * has sent a message since the last barrier.
+ */
+inline bool comm::barrier_counts_terminated(
+    const std::pair<uint64_t, uint64_t> &previous_counts,
+    const std::pair<uint64_t, uint64_t> &current_counts) const {
+  return current_counts.first == current_counts.second &&
+         (previous_counts == current_counts ||
+          current_counts == m_last_barrier_counts);
+}
+
 /**
  * @brief Control Flow Barrier
  * Only blocks the control flow until all processes in the communicator have
@@ -483,22 +1041,35 @@ inline size_t comm::pack_header(ygm::detail::byte_vector &packed, const int dest
   return packed.size() - size_before;
 }
 
+/**
+ * @brief Sums message counts over all ranks, first within each node and then
+ * across node leaders, while continuing to process incoming messages.
+ */
 inline std::pair<uint64_t, uint64_t> comm::barrier_reduce_counts() {
-  uint64_t local_counts[2]  = {m_recv_count, m_send_count};
-  uint64_t global_counts[2] = {0, 0};
-
-  YGM_ASSERT_RELEASE(m_pending_isend_bytes == 0);
-  YGM_ASSERT_RELEASE(m_send_local_buffer_bytes == 0);
-  YGM_ASSERT_RELEASE(m_send_remote_buffer_bytes == 0);
+  detail::event_tracer::scope trace(
+      m_tracer.get(), detail::event_tracer::event_type::barrier_round);
 
-  MPI_Request req = MPI_REQUEST_NULL;
-  YGM_ASSERT_MPI(MPI_Iallreduce(local_counts, global_counts, 2, MPI_UINT64_T,
-                                MPI_SUM, m_comm_barrier, &req));
-  stats.iallreduce();
+  barrier_reduce_counts_start();
   bool iallreduce_complete(false);
+  if (m_progress_thread_enabled || config.probe_recv) {
+    // Receives are completed by the progress thread, or are only posted once
+    // probed, so only the reduction can be waited on here.
+    detail::event_tracer::scope trace_wait(
+        m_tracer.get(), detail::event_tracer::event_type::iallreduce_wait,
+        stats.get_iallreduce_count());
+    while (!iallreduce_complete) {
+      {
+        auto timer          = stats.waitsome_iallreduce();
+        iallreduce_complete = m_count_reducer->test();
+      }
+      if (!iallreduce_complete && local_process_incoming()) {
+        flush_all_local_and_process_incoming();
+      }
+    }
+  }
   while (!iallreduce_complete) {
     MPI_Request twin_req[2];
-    twin_req[0] = req;
+    twin_req[0] = m_count_reducer->request();
     twin_req[1] = m_recv_queue.front().request;
 
     int        outcount{0};
@@ -507,6 +1078,9 @@ inline std::pair<uint64_t, uint64_t> comm::barrier_reduce_counts() {
 
     {
       auto timer = stats.waitsome_iallreduce();
+      detail::event_tracer::scope trace_wait(
+          m_tracer.get(), detail::event_tracer::event_type::iallreduce_wait,
+          stats.get_iallreduce_count());
       while (outcount == 0) {
         YGM_ASSERT_MPI(
             MPI_Testsome(2, twin_req, &outcount, twin_indices, twin_status));
@@ -514,22 +1088,36 @@ inline std::pair<uint64_t, uint64_t> comm::barrier_reduce_counts() {
     }
 
     for (int i = 0; i < outcount; ++i) {
-      if (twin_indices[i] == 0) {  // completed a Iallreduce
-        iallreduce_complete = true;
-        // std::cout << m_layout.rank() << ": iallreduce_complete: " <<
-        // global_counts[0] << " " << global_counts[1] << std::endl;
+      if (twin_indices[i] == 0) {  // completed a reduction stage
+        iallreduce_complete = m_count_reducer->complete_stage();
       } else {
         mpi_irecv_request req_buffer = m_recv_queue.front();
         m_recv_queue.pop_front();
         int buffer_size{0};
         YGM_ASSERT_MPI(MPI_Get_count(&twin_status[i], MPI_BYTE, &buffer_size));
         stats.irecv(twin_status[i].MPI_SOURCE, buffer_size);
-        handle_next_receive(req_buffer.buffer, buffer_size);
+        handle_next_receive(req_buffer.buffer, buffer_size,
+                            twin_status[i].MPI_TAG);
         flush_all_local_and_process_incoming();
       }
     }
   }
-  return {global_counts[0], global_counts[1]};
+  std::pair<uint64_t, uint64_t> global_counts = m_count_reducer->result();
+  trace.set_args(global_counts.first, global_counts.second);
+  return global_counts;
+}
+
+/**
+ * @brief Posts a round of count reduction once all local sends are complete
+ */
+inline void comm::barrier_reduce_counts_start() {
+  YGM_ASSERT_RELEASE(m_pending_isend_bytes == 0);
+  YGM_ASSERT_RELEASE(m_send_local_buffer_bytes == 0);
+  YGM_ASSERT_RELEASE(m_send_remote_buffer_bytes == 0);
+  YGM_ASSERT_RELEASE(m_urgent_buffer_bytes == 0);
+
+  m_count_reducer->start(m_recv_count, m_send_count);
+  stats.iallreduce();
 }
 
 /**
@@ -538,126 +1126,397 @@ inline std::pair<uint64_t, uint64_t> comm::barrier_reduce_counts() {
  * @param dest
  */
 inline void comm::flush_send_buffer(int dest) {
-  static size_t counter = 0;
   if (m_vec_send_buffers[dest].size() > 0) {
-    check_completed_sends();
-    mpi_isend_request request;
-    if (m_free_send_buffers.empty()) {
-      request.buffer = std::make_shared<ygm::detail::byte_vector>();
-    } else {
-      request.buffer = m_free_send_buffers.back();
-      m_free_send_buffers.pop_back();
-    }
-    request.buffer->swap(m_vec_send_buffers[dest]);
-    if (config.freq_issend > 0 && counter++ % config.freq_issend == 0) {
-      YGM_ASSERT_MPI(MPI_Issend(request.buffer->data(), request.buffer->size(),
-                                MPI_BYTE, dest, 0, m_comm_async,
-                                &(request.request)));
-    } else {
-      YGM_ASSERT_MPI(MPI_Isend(request.buffer->data(), request.buffer->size(),
-                               MPI_BYTE, dest, 0, m_comm_async,
-                               &(request.request)));
+    if (!m_send_buffer_start_times.empty()) {
+      stats.buffer_age(MPI_Wtime() - m_send_buffer_start_times[dest]);
+    }
+    if (m_handler_runs) {
+      m_handler_runs->reset(dest);
+    }
+    if (!m_send_dictionaries.empty()) {
+      m_send_dictionaries[dest].clear();
+    }
+    detail::event_tracer::scope trace(m_tracer.get(),
+                                      detail::event_tracer::event_type::flush,
+                                      dest, m_vec_send_buffers[dest].size());
+    if (m_buffer_policy) {
+      m_buffer_policy->record_flush(dest, m_vec_send_buffers[dest].size());
     }
-    stats.isend(dest, request.buffer->size());
-    m_pending_isend_bytes += request.buffer->size();
+    if (uses_transport(dest) && !m_transport_bypass[dest]) {
+      ygm::detail::byte_vector &send_buff = m_vec_send_buffers[dest];
+      if (m_transport_backlog[dest].empty() && transport_push(dest, send_buff)) {
+        if (m_layout.is_local(dest)) {
+          m_send_local_buffer_bytes -= send_buff.size();
+        } else {
+          m_send_remote_buffer_bytes -= send_buff.size();
+        }
+        send_buff.clear();
+        if (!m_in_process_receive_queue) {
+          process_receive_queue();
+        }
+        return;
+      }
+      if (!m_transport_backlog[dest].empty() || !transport_drained(dest)) {
+        // No room at dest, so wait behind the buffers still in the transport
+        backlog_send_buffer(dest);
+        if (!m_in_process_receive_queue) {
+          process_receive_queue();
+        }
+        return;
+      }
+      // Transport has drained but cannot fit the buffer, fall back to MPI
+      m_transport_bypass[dest] = true;
+    }
+    if (!m_progress_thread_enabled) {
+      check_completed_sends();
+    }
+    std::shared_ptr<ygm::detail::byte_vector> buffer = get_free_send_buffer();
+    buffer->swap(m_vec_send_buffers[dest]);
 
     if (m_layout.is_local(dest)) {
-      m_send_local_buffer_bytes -= request.buffer->size();
+      m_send_local_buffer_bytes -= buffer->size();
     } else {
-      m_send_remote_buffer_bytes -= request.buffer->size();
+      m_send_remote_buffer_bytes -= buffer->size();
     }
-    
-    m_send_queue.push_back(request);
+
+    isend_send_buffer(dest, buffer);
     if (!m_in_process_receive_queue) {
       process_receive_queue();
     }
   }
 }
 
-
-inline void comm::flush_next_send(std::deque<int> &dest_queue) {
-  if (!dest_queue.empty()) {
-    int dest = dest_queue.front();
-    dest_queue.pop_front();
-    flush_send_buffer(dest);
+/**
+ * @brief Compresses and posts the MPI_Isend of a flushed send buffer
+ */
+inline void comm::isend_send_buffer(
+    int dest, std::shared_ptr<ygm::detail::byte_vector> &buffer) {
+  int tag = compress_send_buffer(dest, buffer);
+  stats.isend(dest, buffer->size());
+  m_pending_isend_bytes += buffer->size();
+
+  if (m_progress_thread_enabled) {
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+    m_progress_outbox.push_back({dest, tag, buffer});
+  } else {
+    post_isend(dest, tag, buffer);
   }
 }
 
 /**
- * @brief Handle a completed send by putting the buffer on the free list or
- * allowing it to be freed
+ * @brief True if buffers to dest go through the shm or RMA transport
  */
-inline void comm::handle_completed_send(mpi_isend_request &req_buffer) {
-  m_pending_isend_bytes -= req_buffer.buffer->size();
-  if (m_free_send_buffers.size() < config.send_buffer_free_list_len) {
-    req_buffer.buffer->clear();
-    m_free_send_buffers.push_back(req_buffer.buffer);
-  }
+inline bool comm::uses_transport(int dest) const {
+  return (m_shm && m_layout.is_local(dest)) || m_rma;
 }
 
 /**
- * @brief Test completed sends
+ * @brief Writes a flushed buffer into the transport used for dest
+ *
+ * @return False if the transport has no room for the buffer
  */
-inline void comm::check_completed_sends() {
-  if (!m_send_queue.empty()) {
-    int flag(1);
-    while (flag && not m_send_queue.empty()) {
-      YGM_ASSERT_MPI(
-          MPI_Test(&(m_send_queue.front().request), &flag, MPI_STATUS_IGNORE));
-      stats.isend_test();
-      if (flag) {
-        handle_completed_send(m_send_queue.front());
-        m_send_queue.pop_front();
-      }
+inline bool comm::transport_push(int dest,
+                                 const ygm::detail::byte_vector &buffer) {
+  if (m_shm && m_layout.is_local(dest)) {
+    if (m_shm->try_push(dest, buffer.data(), buffer.size())) {
+      stats.shm_send(dest, buffer.size());
+      return true;
     }
+  } else if (m_rma->try_push(dest, buffer.data(), buffer.size())) {
+    stats.rma_send(dest, buffer.size());
+    return true;
   }
-}
-
-inline void comm::check_if_production_halt_required() {
-  while (m_enable_interrupts && !m_in_process_receive_queue &&
-         m_pending_isend_bytes > (config.local_buffer_size + config.remote_buffer_size)) {
-    process_receive_queue();
-  }
+  return false;
 }
 
 /**
- * @brief Checks for incoming unless called from receive queue and flushes
- * one buffer.
+ * @brief True once dest has dispatched every buffer pushed to it through the
+ * transport
  */
-inline void comm::local_progress() {
-  if (not m_in_process_receive_queue) {
-    process_receive_queue();
-  }
-  if (not m_send_local_dest_queue.empty()) {
-    flush_next_send(m_send_local_dest_queue);
-  }
-  if (not m_send_remote_dest_queue.empty()) {
-    flush_next_send(m_send_remote_dest_queue);
+inline bool comm::transport_drained(int dest) const {
+  if (m_shm && m_layout.is_local(dest)) {
+    return m_shm->drained(dest);
   }
+  return m_rma->drained(dest);
 }
 
 /**
- * @brief Waits until provided condition function returns true.
- *
- * @tparam Function
- * @param fn Wait condition function, must match []() -> bool
+ * @brief Moves the send buffer of dest to the back of its transport backlog
  */
-template <typename Function>
-inline void comm::local_wait_until(Function fn) {
-  while (not fn()) {
-    local_progress();
+inline void comm::backlog_send_buffer(int dest) {
+  std::shared_ptr<ygm::detail::byte_vector> buffer = get_free_send_buffer();
+  buffer->swap(m_vec_send_buffers[dest]);
+  if (m_layout.is_local(dest)) {
+    m_send_local_buffer_bytes -= buffer->size();
+  } else {
+    m_send_remote_buffer_bytes -= buffer->size();
   }
+  if (m_transport_backlog[dest].empty()) {
+    m_transport_backlog_dests.push_back(dest);
+  }
+  m_transport_backlog_bytes += buffer->size();
+  m_transport_backlog[dest].push_back(buffer);
 }
 
 /**
- * @brief Flushes all local state and buffers.
+ * @brief Pushes backlogged buffers into the transport in the order they were
+ * flushed.  A backlog only moves to MPI once everything ahead of it has been
+ * dispatched by dest, so MPI messages cannot overtake transport records.
+ */
+inline void comm::drain_transport_backlog() {
+  size_t kept = 0;
+  for (int dest : m_transport_backlog_dests) {
+    auto &backlog = m_transport_backlog[dest];
+    while (!backlog.empty()) {
+      std::shared_ptr<ygm::detail::byte_vector> buffer = backlog.front();
+      if (!m_transport_bypass[dest]) {
+        if (transport_push(dest, *buffer)) {
+          m_transport_backlog_bytes -= buffer->size();
+          backlog.pop_front();
+          recycle_send_buffer(buffer);
+          continue;
+        }
+        if (!transport_drained(dest)) {
+          break;
+        }
+        m_transport_bypass[dest] = true;
+      }
+      m_transport_backlog_bytes -= buffer->size();
+      backlog.pop_front();
+      isend_send_buffer(dest, buffer);
+    }
+    if (!backlog.empty()) {
+      m_transport_backlog_dests[kept++] = dest;
+    }
+  }
+  m_transport_backlog_dests.resize(kept);
+}
+
+/**
+ * @brief Urgent lane buffer for dest, queueing dest for the next flush
+ */
+inline ygm::detail::byte_vector &comm::urgent_buffer(int dest) {
+  if (m_vec_urgent_buffers[dest].empty()) {
+    m_urgent_dest_queue.push_back(dest);
+  }
+  return m_vec_urgent_buffers[dest];
+}
+
+/**
+ * @brief Sends every non-empty urgent lane buffer.  Urgent buffers are never
+ * compressed or sent through shared memory.
+ */
+inline void comm::flush_urgent_buffers() {
+  while (!m_urgent_dest_queue.empty()) {
+    int dest = m_urgent_dest_queue.front();
+    m_urgent_dest_queue.pop_front();
+
+    std::shared_ptr<ygm::detail::byte_vector> buffer = get_free_send_buffer();
+    buffer->swap(m_vec_urgent_buffers[dest]);
+    m_urgent_buffer_bytes -= buffer->size();
+
+    stats.urgent_flush();
+    stats.isend(dest, buffer->size());
+    m_pending_isend_bytes += buffer->size();
+
+    if (m_progress_thread_enabled) {
+      std::lock_guard<std::mutex> lock(m_progress_mutex);
+      m_progress_outbox.push_back({dest, tag_urgent, buffer});
+    } else {
+      post_isend(dest, tag_urgent, buffer);
+    }
+  }
+}
+
+/**
+ * @brief Compresses a flushed buffer in place when YGM_COMM_COMPRESS covers
+ * dest and the buffer is at least YGM_COMM_COMPRESS_MIN_SIZE_KB.  Buffers that
+ * do not shrink are sent as-is.
+ *
+ * @return MPI tag the buffer must be sent with
+ */
+inline int comm::compress_send_buffer(
+    int dest, std::shared_ptr<ygm::detail::byte_vector> &buffer) {
+  if (config.compress == detail::compression_type::NONE ||
+      (config.compress == detail::compression_type::REMOTE &&
+       m_layout.is_local(dest)) ||
+      buffer->size() < config.compress_min_size) {
+    return tag_raw;
+  }
+  size_t compressed_size(0);
+  {
+    auto timer = stats.compress();
+    compressed_size =
+        m_codec.compress(buffer->data(), buffer->size(), m_compress_buffer);
+  }
+  stats.compressed(buffer->size(),
+                   compressed_size > 0 ? compressed_size : buffer->size());
+  if (compressed_size == 0) {
+    return tag_raw;
+  }
+  // The raw buffer's storage is kept as the next compression target
+  buffer->swap(m_compress_buffer);
+  return tag_compressed;
+}
+
+/**
+ * @brief Posts the MPI_Isend (or periodic MPI_Issend) of a flushed buffer.
+ * Called by the progress thread when it is enabled.
+ */
+inline void comm::post_isend(int dest, int tag,
+                             std::shared_ptr<ygm::detail::byte_vector> &buffer) {
+  static size_t     counter = 0;
+  mpi_isend_request request;
+  request.buffer = buffer;
+  if (config.freq_issend > 0 && counter++ % config.freq_issend == 0) {
+    YGM_ASSERT_MPI(MPI_Issend(request.buffer->data(), request.buffer->size(),
+                              MPI_BYTE, dest, tag, m_comm_async,
+                              &(request.request)));
+  } else {
+    YGM_ASSERT_MPI(MPI_Isend(request.buffer->data(), request.buffer->size(),
+                             MPI_BYTE, dest, tag, m_comm_async,
+                             &(request.request)));
+  }
+  m_send_queue.push_back(request);
+}
+
+/**
+ * @brief Takes a buffer from the free list, or allocates a new one
+ */
+inline std::shared_ptr<ygm::detail::byte_vector> comm::get_free_send_buffer() {
+  std::unique_lock<std::mutex> lock(m_progress_mutex, std::defer_lock);
+  if (m_progress_thread_enabled) {
+    lock.lock();
+  }
+  if (m_free_send_buffers.empty()) {
+    return std::make_shared<ygm::detail::byte_vector>();
+  }
+  std::shared_ptr<ygm::detail::byte_vector> to_return =
+      m_free_send_buffers.back();
+  m_free_send_buffers.pop_back();
+  return to_return;
+}
+
+
+inline void comm::flush_next_send(std::deque<int> &dest_queue) {
+  if (!dest_queue.empty()) {
+    int dest = dest_queue.front();
+    dest_queue.pop_front();
+    m_send_dest_queued[dest] = false;
+    flush_send_buffer(dest);
+  }
+}
+
+/**
+ * @brief Handle a completed send by putting the buffer on the free list or
+ * allowing it to be freed
+ */
+inline void comm::handle_completed_send(mpi_isend_request &req_buffer) {
+  m_pending_isend_bytes -= req_buffer.buffer->size();
+  recycle_send_buffer(req_buffer.buffer);
+}
+
+/**
+ * @brief Returns a sent buffer to the free list, unless the list is full
+ */
+inline void comm::recycle_send_buffer(
+    std::shared_ptr<ygm::detail::byte_vector> &buffer) {
+  std::unique_lock<std::mutex> lock(m_progress_mutex, std::defer_lock);
+  if (m_progress_thread_enabled) {
+    lock.lock();
+  }
+  if (m_free_send_buffers.size() < config.send_buffer_free_list_len) {
+    buffer->clear();
+    m_free_send_buffers.push_back(buffer);
+  }
+}
+
+/**
+ * @brief Test completed sends
+ */
+inline void comm::check_completed_sends() {
+  if (!m_send_queue.empty()) {
+    int flag(1);
+    while (flag && not m_send_queue.empty()) {
+      YGM_ASSERT_MPI(
+          MPI_Test(&(m_send_queue.front().request), &flag, MPI_STATUS_IGNORE));
+      if (!m_progress_thread_enabled) {
+        stats.isend_test();
+      }
+      if (flag) {
+        handle_completed_send(m_send_queue.front());
+        m_send_queue.pop_front();
+      }
+    }
+  }
+}
+
+/**
+ * @brief True while flushed buffers have not completed sending
+ */
+inline bool comm::sends_in_flight() const {
+  if (m_transport_backlog_bytes > 0) {
+    return true;
+  }
+  if (m_progress_thread_enabled) {
+    return m_pending_isend_bytes > 0;
+  }
+  return !m_send_queue.empty();
+}
+
+inline void comm::check_if_production_halt_required() {
+  while (m_enable_interrupts && !m_in_process_receive_queue &&
+         m_pending_isend_bytes + m_transport_backlog_bytes >
+             (config.local_buffer_size + config.remote_buffer_size)) {
+    process_receive_queue();
+  }
+}
+
+/**
+ * @brief Checks for incoming unless called from receive queue and flushes
+ * one buffer.
+ */
+inline void comm::local_progress() {
+  async_lock_guard lock(this);
+  if (m_thread_safe_async) {
+    coalesce_thread_send_buffers(local_thread_send_buffers());
+  }
+  if (not m_in_process_receive_queue) {
+    process_receive_queue();
+  }
+  if (not m_send_local_dest_queue.empty()) {
+    flush_next_send(m_send_local_dest_queue);
+  }
+  if (not m_send_remote_dest_queue.empty()) {
+    flush_next_send(m_send_remote_dest_queue);
+  }
+  flush_expired_buffers();
+  flush_urgent_buffers();
+}
+
+/**
+ * @brief Waits until provided condition function returns true.
+ *
+ * @tparam Function
+ * @param fn Wait condition function, must match []() -> bool
+ */
+template <typename Function>
+inline void comm::local_wait_until(Function fn) {
+  while (not fn()) {
+    local_progress();
+  }
+}
+
+/**
+ * @brief Flushes all local state and buffers.
  * Notifies any registered barrier watchers.
  */
 inline void comm::flush_all_local_and_process_incoming() {
   // Keep flushing until all local work is complete
   bool did_something = true;
   while (did_something) {
-    did_something = process_receive_queue();
+    did_something = coalesce_all_thread_send_buffers();
+    did_something |= process_receive_queue();
     //
     //  Notify registered barrier watchers
     while (!m_pre_barrier_callbacks.empty()) {
@@ -667,6 +1526,11 @@ inline void comm::flush_all_local_and_process_incoming() {
       fn();
     }
 
+    if (!m_urgent_dest_queue.empty()) {
+      did_something = true;
+      flush_urgent_buffers();
+    }
+
     //
     //  Flush each send buffer
     while (!m_send_local_dest_queue.empty()) {
@@ -682,7 +1546,7 @@ inline void comm::flush_all_local_and_process_incoming() {
 
     //
     // Wait on isends
-    while (!m_send_queue.empty()) {
+    while (sends_in_flight()) {
       did_something |= process_receive_queue();
     }
   }
@@ -703,11 +1567,96 @@ inline void comm::flush_to_capacity() {
   }
 }
 
+/**
+ * @brief Flushes dest on its own once its buffer reaches the threshold chosen
+ * by the adaptive buffer policy
+ */
+inline void comm::flush_if_over_threshold(int dest) {
+  if (m_buffer_policy && m_vec_send_buffers[dest].size() >=
+                             m_buffer_policy->flush_threshold(dest)) {
+    stats.adaptive_flush();
+    flush_send_buffer(dest);
+  }
+}
+
+/**
+ * @brief Queues dest for flushing when its send buffer receives its first
+ * message, noting the time for YGM_COMM_MAX_BUFFER_AGE_US.  A dest flushed out
+ * of order keeps its place in the queue instead of being queued twice.
+ */
+inline void comm::queue_send_dest(int dest) {
+  if (!m_send_dest_queued[dest]) {
+    if (m_layout.is_local(dest)) {
+      m_send_local_dest_queue.push_back(dest);
+    } else {
+      m_send_remote_dest_queue.push_back(dest);
+    }
+    m_send_dest_queued[dest] = true;
+  }
+  if (!m_send_buffer_start_times.empty()) {
+    double now                      = MPI_Wtime();
+    m_send_buffer_start_times[dest] = now;
+    m_send_buffer_expiry_queue.emplace_back(now, dest);
+  }
+}
+
+/**
+ * @brief Flushes buffers whose first message is older than
+ * YGM_COMM_MAX_BUFFER_AGE_US.  The expiry queue is in first-message order;
+ * entries whose buffer has since been flushed no longer match its start time
+ * and are dropped.
+ */
+inline void comm::flush_expired_buffers() {
+  if (m_send_buffer_start_times.empty()) {
+    return;
+  }
+  double oldest_allowed = MPI_Wtime() - config.max_buffer_age_us * 1e-6;
+  while (!m_send_buffer_expiry_queue.empty()) {
+    auto [start_time, dest] = m_send_buffer_expiry_queue.front();
+    if (start_time > oldest_allowed) {
+      break;
+    }
+    m_send_buffer_expiry_queue.pop_front();
+    if (m_vec_send_buffers[dest].empty() ||
+        m_send_buffer_start_times[dest] != start_time) {
+      continue;
+    }
+    stats.age_flush();
+    flush_send_buffer(dest);
+  }
+}
+
+/**
+ * @brief Bytes to reserve for a destination's send buffer on first use
+ */
+inline size_t comm::send_buffer_reserve_size(int dest) const {
+  if (m_buffer_policy) {
+    return m_buffer_policy->reserve_size(dest);
+  }
+  if (m_layout.is_local(dest)) {
+    return config.local_buffer_size / m_layout.local_size();
+  }
+  return config.remote_buffer_size / m_layout.node_size();
+}
+
 inline void comm::post_new_irecv(std::shared_ptr<ygm::detail::byte_vector> &recv_buffer) {
+  if (config.probe_recv) {
+    // Receives are posted by probe_new_irecvs(), just recycle the buffer
+    m_recv_buffer_pool.release(recv_buffer);
+    return;
+  }
   recv_buffer->clear();
   mpi_irecv_request recv_req;
   recv_req.buffer = recv_buffer;
 
+  if (!m_persistent_recvs.empty()) {
+    // Restart the request bound to this buffer by MPI_Recv_init
+    recv_req.request = m_persistent_recvs.at(recv_buffer.get());
+    YGM_ASSERT_MPI(MPI_Start(&(recv_req.request)));
+    m_recv_queue.push_back(recv_req);
+    return;
+  }
+
   //::madvise(recv_req.buffer.get(), config.irecv_size, MADV_DONTNEED);
   YGM_ASSERT_MPI(MPI_Irecv(recv_req.buffer.get()->data(), config.irecv_size, MPI_BYTE,
                        MPI_ANY_SOURCE, MPI_ANY_TAG, m_comm_async,
@@ -715,14 +1664,43 @@ inline void comm::post_new_irecv(std::shared_ptr<ygm::detail::byte_vector> &recv
   m_recv_queue.push_back(recv_req);
 }
 
-template <typename Lambda, typename... PackArgs>
-inline size_t comm::pack_lambda(ygm::detail::byte_vector &packed, Lambda l,
-                                const PackArgs &...args) {
-  size_t                        size_before = packed.size();
-  const std::tuple<PackArgs...> tuple_args(
-      std::forward<const PackArgs>(args)...);
+/**
+ * @brief Matches arrived messages with MPI_Improbe and posts an MPI_Imrecv
+ * into a pooled buffer sized to each message.  Used instead of pre-posted
+ * irecvs when YGM_COMM_PROBE_RECV is set.
+ *
+ * @return True if any receives were posted
+ */
+inline bool comm::probe_new_irecvs() {
+  bool posted = false;
+  while (true) {
+    int         flag(0);
+    MPI_Message message;
+    MPI_Status  status;
+    YGM_ASSERT_MPI(MPI_Improbe(MPI_ANY_SOURCE, MPI_ANY_TAG, m_comm_async,
+                               &flag, &message, &status));
+    if (!flag) {
+      break;
+    }
+    int count{0};
+    YGM_ASSERT_MPI(MPI_Get_count(&status, MPI_BYTE, &count));
+    mpi_irecv_request recv_req;
+    recv_req.buffer = m_recv_buffer_pool.acquire(count);
+    YGM_ASSERT_MPI(MPI_Imrecv(recv_req.buffer->data(), count, MPI_BYTE,
+                              &message, &(recv_req.request)));
+    m_recv_queue.push_back(recv_req);
+    posted = true;
+  }
+  return posted;
+}
 
-  auto dispatch_lambda = [](comm *c, cereal::YGMInputArchive *bia, Lambda l) {
+/**
+ * @brief Handler logic of async(): unpacks the arguments and calls the user
+ * function object
+ */
+template <typename Lambda, typename... PackArgs>
+inline auto comm::make_dispatch_lambda() {
+  return [](comm *c, cereal::YGMInputArchive *bia, Lambda l) {
     Lambda *pl = nullptr;
     size_t  l_storage[sizeof(Lambda) / sizeof(size_t) +
                      (sizeof(Lambda) % sizeof(size_t) > 0)];
@@ -732,17 +1710,22 @@ inline size_t comm::pack_lambda(ygm::detail::byte_vector &packed, Lambda l,
     }
 
     std::tuple<PackArgs...> ta;
-    if constexpr (!std::is_empty<std::tuple<PackArgs...>>::value) {
-      (*bia)(ta);
-    }
+    detail::unpack_arguments(*bia, ta);
 
     auto t1 = std::make_tuple((comm *)c);
 
     // \pp was: std::apply(*pl, std::tuple_cat(t1, ta));
     ygm::meta::apply_optional(*pl, std::move(t1), std::move(ta));
   };
+}
+
+template <typename Lambda, typename... PackArgs>
+inline size_t comm::pack_lambda(ygm::detail::byte_vector  &packed,
+                                detail::string_dictionary *dictionary, Lambda l,
+                                const PackArgs &...args) {
+  auto dispatch_lambda = make_dispatch_lambda<Lambda, PackArgs...>();
 
-  return pack_lambda_generic(packed, l, dispatch_lambda,
+  return pack_lambda_generic(packed, dictionary, l, dispatch_lambda,
                              std::forward<const PackArgs>(args)...);
 }
 
@@ -763,9 +1746,7 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
     }
 
     std::tuple<PackArgs...> ta;
-    if constexpr (!std::is_empty<std::tuple<PackArgs...>>::value) {
-      (*bia)(ta);
-    }
+    detail::unpack_arguments(*bia, ta);
 
     auto forward_local_and_dispatch_lambda =
         [](comm *c, cereal::YGMInputArchive *bia, Lambda l) {
@@ -778,9 +1759,7 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
           }
 
           std::tuple<PackArgs...> ta;
-          if constexpr (!std::is_empty<std::tuple<PackArgs...>>::value) {
-            (*bia)(ta);
-          }
+          detail::unpack_arguments(*bia, ta);
 
           auto local_dispatch_lambda = [](comm *c, cereal::YGMInputArchive *bia,
                                           Lambda l) {
@@ -793,9 +1772,7 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
             }
 
             std::tuple<PackArgs...> ta;
-            if constexpr (!std::is_empty<std::tuple<PackArgs...>>::value) {
-              (*bia)(ta);
-            }
+            detail::unpack_arguments(*bia, ta);
 
             auto t1 = std::make_tuple((comm *)c);
 
@@ -803,11 +1780,14 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
             ygm::meta::apply_optional(*pl, std::move(t1), std::move(ta));
           };
 
-          // Pack lambda telling terminal ranks to execute user lambda.
-          // TODO: Why does this work? Passing ta (tuple of args) to a function
-          // expecting a parameter pack shouldn't work...
+          // Pack lambda telling terminal ranks to execute user lambda
           ygm::detail::byte_vector packed_msg;
-          c->pack_lambda_generic(packed_msg, *pl, local_dispatch_lambda, ta);
+          std::apply(
+              [&](const PackArgs &...args) {
+                c->pack_lambda_generic(packed_msg, nullptr, *pl,
+                                       local_dispatch_lambda, args...);
+              },
+              ta);
 
           for (auto dest : c->layout().local_ranks()) {
             if (dest != c->layout().rank()) {
@@ -822,8 +1802,12 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
         };
 
     ygm::detail::byte_vector packed_msg;
-    c->pack_lambda_generic(packed_msg, *pl, forward_local_and_dispatch_lambda,
-                           ta);
+    std::apply(
+        [&](const PackArgs &...args) {
+          c->pack_lambda_generic(packed_msg, nullptr, *pl,
+                                 forward_local_and_dispatch_lambda, args...);
+        },
+        ta);
 
     int num_layers = c->layout().node_size() / c->layout().local_size() +
                      (c->layout().node_size() % c->layout().local_size() > 0);
@@ -860,7 +1844,8 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
   };
 
   ygm::detail::byte_vector packed_msg;
-  pack_lambda_generic(packed_msg, l, forward_remote_and_dispatch_lambda,
+  pack_lambda_generic(packed_msg, nullptr, l,
+                      forward_remote_and_dispatch_lambda,
                       std::forward<const PackArgs>(args)...);
 
   // Initial send to all local ranks
@@ -869,14 +1854,11 @@ inline void comm::pack_lambda_broadcast(Lambda l, const PackArgs &...args) {
   }
 }
 
-template <typename Lambda, typename RemoteLogicLambda, typename... PackArgs>
-inline size_t comm::pack_lambda_generic(ygm::detail::byte_vector &packed,
-                                        Lambda l, RemoteLogicLambda rll,
-                                        const PackArgs &...args) {
-  size_t                        size_before = packed.size();
-  const std::tuple<PackArgs...> tuple_args(
-      std::forward<const PackArgs>(args)...);
-
+/**
+ * @brief Handler id of messages running RemoteLogicLambda on a Lambda
+ */
+template <typename Lambda, typename RemoteLogicLambda>
+inline uint16_t comm::register_handler() {
   auto remote_dispatch_lambda = [](comm *c, cereal::YGMInputArchive *bia) {
     RemoteLogicLambda *rll = nullptr;
     Lambda            *pl  = nullptr;
@@ -884,7 +1866,18 @@ inline size_t comm::pack_lambda_generic(ygm::detail::byte_vector &packed,
     (*rll)(c, bia, *pl);
   };
 
-  uint16_t lid = m_lambda_map.register_lambda(remote_dispatch_lambda);
+  return decltype(m_lambda_map)::template register_lambda<Lambda>(
+      remote_dispatch_lambda);
+}
+
+template <typename Lambda, typename RemoteLogicLambda, typename... PackArgs>
+inline size_t comm::pack_lambda_generic(ygm::detail::byte_vector  &packed,
+                                        detail::string_dictionary *dictionary,
+                                        Lambda l, RemoteLogicLambda rll,
+                                        const PackArgs &...args) {
+  size_t size_before = packed.size();
+
+  uint16_t lid = register_handler<Lambda, RemoteLogicLambda>();
 
   {
     packed.push_bytes(&lid, sizeof(lid));
@@ -896,11 +1889,8 @@ inline size_t comm::pack_lambda_generic(ygm::detail::byte_vector &packed,
     packed.push_bytes(&l, sizeof(Lambda));
   }
 
-  if constexpr (!std::is_empty<std::tuple<PackArgs...>>::value) {
-    // Only create cereal archive is tuple needs serialization
-    cereal::YGMOutputArchive oarchive(packed);  // Create an output archive
-    oarchive(tuple_args);
-  }
+  detail::pack_arguments(packed, {m_pack_options.compact, dictionary},
+                         args...);
   return packed.size() - size_before;
 }
 
@@ -916,15 +1906,8 @@ inline void comm::queue_message_bytes(const ygm::detail::byte_vector
   //
   // add data to the dest buffer
   if (m_vec_send_buffers[dest].empty()) {
-    if (local) {
-      m_send_local_dest_queue.push_back(dest);
-      m_vec_send_buffers[dest].reserve(config.local_buffer_size /
-                                       m_layout.local_size());
-    } else {
-      m_send_remote_dest_queue.push_back(dest);
-      m_vec_send_buffers[dest].reserve(config.remote_buffer_size /
-                                       m_layout.node_size());
-    }
+    queue_send_dest(dest);
+    m_vec_send_buffers[dest].reserve(send_buffer_reserve_size(dest));
   }
 
   ygm::detail::byte_vector &send_buff = m_vec_send_buffers[dest];
@@ -950,62 +1933,213 @@ inline void comm::queue_message_bytes(const ygm::detail::byte_vector
 }
 
 inline void comm::handle_next_receive(std::shared_ptr<ygm::detail::byte_vector> &buffer,
-                                      const size_t buffer_size) {
-  cereal::YGMInputArchive iarchive(buffer.get()->data(), buffer_size);
+                                      const size_t buffer_size, const int tag) {
+  if (tag == tag_compressed) {
+    size_t raw_size = detail::lz_codec::decompressed_size(buffer->data());
+    std::shared_ptr<ygm::detail::byte_vector> raw =
+        m_decompress_buffer_pool.acquire(raw_size);
+    {
+      auto timer = stats.decompress();
+      detail::lz_codec::decompress(buffer->data(), buffer_size, raw->data());
+    }
+    dispatch_receive_buffer(raw->data(), raw_size);
+    m_decompress_buffer_pool.release(raw);
+  } else {
+    dispatch_receive_buffer(buffer.get()->data(), buffer_size,
+                            tag == tag_urgent);
+  }
+  if (m_progress_thread_enabled) {
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+    m_progress_repost.push_back(buffer);
+  } else {
+    post_new_irecv(buffer);
+  }
+  flush_to_capacity();
+}
+
+/**
+ * @brief Executes (or forwards, when routing) every message in a received
+ * buffer.  Messages of urgent buffers are forwarded on the urgent lane.
+ */
+inline void comm::dispatch_receive_buffer(std::byte *data, const size_t size,
+                                          bool urgent) {
+  detail::event_tracer::scope trace(
+      m_tracer.get(), detail::event_tracer::event_type::recv_buffer, size);
+  // Dictionary of strings sent in full earlier in this buffer
+  detail::string_dictionary dictionary;
+  cereal::YGMInputArchive   iarchive(
+      data, size, {m_pack_options.compact, &dictionary});
+  bool combined = false;
   while (!iarchive.empty()) {
     if (config.routing != detail::routing_type::NONE) {
       header_t h;
       iarchive.loadBinary(&h, sizeof(header_t));
       if (h.dest == m_layout.rank() || (h.dest == -1 && h.message_size == 0)) {
+        execute_next_handler(iarchive);
+      } else if (urgent) {
+        int next_dest = m_router.next_hop(h.dest);
+        stats.routing(next_dest);
+        ygm::detail::byte_vector &send_buff = urgent_buffer(next_dest);
+        size_t header_bytes = pack_header(send_buff, h.dest, h.message_size);
+        size_t precopy_size = send_buff.size();
+        send_buff.resize(precopy_size + h.message_size);
+        iarchive.loadBinary(&send_buff[precopy_size], h.message_size);
+        m_urgent_buffer_bytes += header_bytes + h.message_size;
+      } else if (detail::route_combiner *combiner =
+                     find_route_combiner(data + iarchive.position())) {
         uint16_t lid;
         iarchive.loadBinary(&lid, sizeof(lid));
-        m_lambda_map.execute(lid, this, &iarchive);
-        m_recv_count++;
-        stats.rpc_execute();
+        if (combiner->absorb(h.dest, iarchive)) {
+          // Counted as received here, as it is never executed
+          m_recv_count++;
+          stats.route_combine();
+        }
+        combined = true;
       } else {
-        int next_dest = m_router.next_hop(h.dest);
-        bool local = m_layout.is_local(next_dest);
+        forward_routed_message(h.dest, iarchive, h.message_size);
+      }
+    } else {
+      execute_next_handler(iarchive);
+    }
+  }
 
-        if (m_vec_send_buffers[next_dest].empty()) {
-          if (local) {
-            m_send_local_dest_queue.push_back(next_dest);
-          } else {
-            m_send_remote_dest_queue.push_back(next_dest);
-          }
-        }
+  if (combined) {
+    for (auto &combiner : m_route_combiners) {
+      if (combiner && combiner->pending_count() > 0) {
+        combiner->drain(m_pack_options, [this](int dest, auto &message) {
+          cereal::YGMInputArchive marchive(message.data(), message.size());
+          forward_routed_message(dest, marchive, message.size());
+        });
+      }
+    }
+  }
+}
 
-        size_t header_bytes =
-            pack_header(m_vec_send_buffers[next_dest], h.dest, h.message_size);
-        if (local) {
-          m_send_local_buffer_bytes += header_bytes;
-        } else {
-          m_send_remote_buffer_bytes += header_bytes;
-        }
+/**
+ * @brief Combiner registered for the handler of the message at data, if any
+ */
+inline detail::route_combiner *comm::find_route_combiner(
+    const std::byte *data) const {
+  if (m_route_combiners.empty()) {
+    return nullptr;
+  }
+  uint16_t lid;
+  std::memcpy(&lid, data, sizeof(lid));
+  return lid < m_route_combiners.size() ? m_route_combiners[lid].get()
+                                        : nullptr;
+}
 
-        size_t precopy_size = m_vec_send_buffers[next_dest].size();
-        m_vec_send_buffers[next_dest].resize(precopy_size + h.message_size);
-        iarchive.loadBinary(&m_vec_send_buffers[next_dest][precopy_size],
-                            h.message_size);
-        if (local) {
-          m_send_local_buffer_bytes += h.message_size;
-        } else {
-          m_send_remote_buffer_bytes += h.message_size;
-        }
+/**
+ * @brief Copies the next message_size bytes of iarchive, a message routed to
+ * dest, into the buffer of its next hop
+ */
+inline void comm::forward_routed_message(int                      dest,
+                                         cereal::YGMInputArchive &iarchive,
+                                         size_t message_size) {
+  int  next_dest = m_router.next_hop(dest);
+  bool local     = m_layout.is_local(next_dest);
+  stats.routing(next_dest);
 
-        flush_to_capacity();
-      }
-    } else {
-      uint16_t lid;
-      iarchive.loadBinary(&lid, sizeof(lid));
-      m_lambda_map.execute(lid, this, &iarchive);
-      m_recv_count++;
-      stats.rpc_execute();
-    }
+  if (m_vec_send_buffers[next_dest].empty()) {
+    queue_send_dest(next_dest);
+  }
+
+  size_t header_bytes =
+      pack_header(m_vec_send_buffers[next_dest], dest, message_size);
+  if (local) {
+    m_send_local_buffer_bytes += header_bytes;
+  } else {
+    m_send_remote_buffer_bytes += header_bytes;
+  }
+
+  size_t precopy_size = m_vec_send_buffers[next_dest].size();
+  m_vec_send_buffers[next_dest].resize(precopy_size + message_size);
+  iarchive.loadBinary(&m_vec_send_buffers[next_dest][precopy_size],
+                      message_size);
+  if (local) {
+    m_send_local_buffer_bytes += message_size;
+  } else {
+    m_send_remote_buffer_bytes += message_size;
   }
-  post_new_irecv(buffer);
+
+  flush_if_over_threshold(next_dest);
   flush_to_capacity();
 }
 
+/**
+ * @brief Reads a handler id from the archive and executes the handler on the
+ * remaining message, or on every message of a run sharing the handler
+ */
+inline void comm::execute_next_handler(cereal::YGMInputArchive &iarchive) {
+  uint16_t lid;
+  iarchive.loadBinary(&lid, sizeof(lid));
+  if (lid != detail::handler_run_encoder::run_marker) {
+    execute_handler(lid, iarchive);
+    return;
+  }
+  detail::handler_run_encoder::count_type count;
+  iarchive.loadBinary(&lid, sizeof(lid));
+  iarchive.loadBinary(&count, sizeof(count));
+  for (detail::handler_run_encoder::count_type i = 0; i < count; ++i) {
+    execute_handler(lid, iarchive);
+  }
+}
+
+/**
+ * @brief Executes handler lid on the next message in the archive
+ */
+inline void comm::execute_handler(uint16_t                 lid,
+                                  cereal::YGMInputArchive &iarchive) {
+  if (stats.traffic_enabled() || stats.handler_profile_enabled() ||
+      m_tracer) {
+    size_t start_position = iarchive.position();
+    double start          = MPI_Wtime();
+    m_lambda_map.execute(lid, this, &iarchive);
+    size_t bytes = iarchive.position() - start_position;
+    stats.handler(lid, bytes, MPI_Wtime() - start);
+    if (m_tracer) {
+      m_tracer->complete(detail::event_tracer::event_type::handler, start, lid,
+                         bytes);
+    }
+  } else {
+    m_lambda_map.execute(lid, this, &iarchive);
+  }
+  m_recv_count++;
+  stats.rpc_execute();
+}
+
+/**
+ * @brief Dispatches buffers written into this rank's shared memory rings
+ *
+ * @return True if any buffers were dispatched
+ */
+inline bool comm::shm_process_incoming() {
+  if (!m_shm) {
+    return false;
+  }
+  return m_shm->poll([this](int source, std::byte *data, size_t size) {
+    stats.irecv(source, size);
+    dispatch_receive_buffer(data, size);
+    flush_to_capacity();
+  });
+}
+
+/**
+ * @brief Dispatches buffers put into this rank's RMA receive slots
+ *
+ * @return True if any buffers were dispatched
+ */
+inline bool comm::rma_process_incoming() {
+  if (!m_rma) {
+    return false;
+  }
+  return m_rma->poll([this](int source, std::byte *data, size_t size) {
+    stats.irecv(source, size);
+    dispatch_receive_buffer(data, size);
+    flush_to_capacity();
+  });
+}
+
 /**
  * @brief Process receive queue of messages received by the listener thread.
  *
@@ -1023,7 +2157,18 @@ inline bool comm::process_receive_queue() {
 
   //
   // if we have a pending iRecv, then we can issue a Testsome
-  if (m_send_queue.size() > config.num_isends_wait) {
+  if (m_progress_thread_enabled) {
+    // sends and receives are progressed by the progress thread
+  } else if (config.probe_recv) {
+    // There is no pre-posted irecv to wait on, so keep probing while waiting
+    // for sends to drain
+    while (m_send_queue.size() > config.num_isends_wait &&
+           !received_to_return) {
+      check_completed_sends();
+      received_to_return |= local_process_incoming();
+    }
+    check_completed_sends();
+  } else if (m_send_queue.size() > config.num_isends_wait) {
     MPI_Request twin_req[2];
     twin_req[0] = m_send_queue.front().request;
     twin_req[1] = m_recv_queue.front().request;
@@ -1049,7 +2194,8 @@ inline bool comm::process_receive_queue() {
         int buffer_size{0};
         YGM_ASSERT_MPI(MPI_Get_count(&twin_status[i], MPI_BYTE, &buffer_size));
         stats.irecv(twin_status[i].MPI_SOURCE, buffer_size);
-        handle_next_receive(req_buffer.buffer, buffer_size);
+        handle_next_receive(req_buffer.buffer, buffer_size,
+                            twin_status[i].MPI_TAG);
       }
     }
   } else {
@@ -1058,14 +2204,29 @@ inline bool comm::process_receive_queue() {
 
   received_to_return |= local_process_incoming();
 
+  // Replies sent by the handlers just run go out without waiting for bulk
+  // buffers to fill
+  flush_urgent_buffers();
+
   m_in_process_receive_queue = false;
   return received_to_return;
 }
 
 inline bool comm::local_process_incoming() {
-  bool received_to_return = false;
+  async_lock_guard lock(this);
+  bool received_to_return = shm_process_incoming();
+  received_to_return      = rma_process_incoming() || received_to_return;
+  if (m_transport_backlog_bytes > 0) {
+    drain_transport_backlog();
+  }
+  if (m_progress_thread_enabled) {
+    return progress_thread_dispatch_incoming() || received_to_return;
+  }
 
-  while (true) {
+  if (config.probe_recv) {
+    probe_new_irecvs();
+  }
+  while (!m_recv_queue.empty()) {
     int        flag(0);
     MPI_Status status;
     YGM_ASSERT_MPI(MPI_Test(&(m_recv_queue.front().request), &flag, &status));
@@ -1077,11 +2238,251 @@ inline bool comm::local_process_incoming() {
       int buffer_size{0};
       YGM_ASSERT_MPI(MPI_Get_count(&status, MPI_BYTE, &buffer_size));
       stats.irecv(status.MPI_SOURCE, buffer_size);
-      handle_next_receive(req_buffer.buffer, buffer_size);
+      handle_next_receive(req_buffer.buffer, buffer_size, status.MPI_TAG);
     } else {
       break;  // not ready yet
     }
   }
   return received_to_return;
 }
+
+/**
+ * @brief Starts the dedicated progress thread if MPI supports it.
+ * Falls back to progressing MPI inline on the calling thread otherwise.
+ */
+inline void comm::progress_thread_start() {
+  int provided(0);
+  YGM_ASSERT_MPI(MPI_Query_thread(&provided));
+  if (provided < MPI_THREAD_MULTIPLE) {
+    if (rank0()) {
+      std::cerr << "YGM_COMM_PROGRESS_THREAD requires MPI_THREAD_MULTIPLE, "
+                   "progressing MPI on the calling thread instead"
+                << std::endl;
+    }
+    return;
+  }
+  m_progress_thread_stop    = false;
+  m_progress_thread_enabled = true;
+  m_progress_thread         = std::thread([this]() { progress_thread_loop(); });
+}
+
+inline void comm::progress_thread_stop() {
+  if (m_progress_thread_enabled) {
+    m_progress_thread_stop = true;
+    m_progress_thread.join();
+    m_progress_thread_enabled = false;
+  }
+}
+
+/**
+ * @brief Body of the progress thread.  Posts handed-off sends, completes
+ * sends and receives, and hands completed receive buffers back to the
+ * application thread for dispatch.
+ */
+inline void comm::progress_thread_loop() {
+  std::deque<queued_isend>                               outbox;
+  std::vector<std::shared_ptr<ygm::detail::byte_vector>> repost;
+  while (!m_progress_thread_stop) {
+    double start = m_tracer ? MPI_Wtime() : 0.0;
+    {
+      std::lock_guard<std::mutex> lock(m_progress_mutex);
+      outbox.swap(m_progress_outbox);
+      repost.swap(m_progress_repost);
+    }
+    bool   did_something = !outbox.empty() || !repost.empty();
+    size_t num_isends    = outbox.size();
+    size_t num_irecvs    = 0;
+    for (auto &isend : outbox) {
+      post_isend(isend.dest, isend.tag, isend.buffer);
+    }
+    outbox.clear();
+    for (auto &buffer : repost) {
+      post_new_irecv(buffer);
+    }
+    repost.clear();
+
+    check_completed_sends();
+
+    if (config.probe_recv) {
+      probe_new_irecvs();
+    }
+    while (!m_recv_queue.empty()) {
+      int        flag(0);
+      MPI_Status status;
+      YGM_ASSERT_MPI(MPI_Test(&(m_recv_queue.front().request), &flag, &status));
+      if (!flag) {
+        break;
+      }
+      did_something = true;
+      ++num_irecvs;
+      int buffer_size{0};
+      YGM_ASSERT_MPI(MPI_Get_count(&status, MPI_BYTE, &buffer_size));
+      std::lock_guard<std::mutex> lock(m_progress_mutex);
+      m_progress_inbox.push_back({m_recv_queue.front().buffer,
+                                  status.MPI_SOURCE, size_t(buffer_size),
+                                  status.MPI_TAG});
+      m_recv_queue.pop_front();
+    }
+
+    if (!did_something) {
+      std::this_thread::yield();
+    } else if (m_tracer) {
+      m_tracer->complete(detail::event_tracer::event_type::progress, start,
+                         num_isends, num_irecvs);
+    }
+  }
+}
+
+/**
+ * @brief Dispatches receive buffers completed by the progress thread.
+ *
+ * @return True if any buffers were dispatched
+ */
+inline bool comm::progress_thread_dispatch_incoming() {
+  std::deque<completed_irecv> inbox;
+  {
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+    inbox.swap(m_progress_inbox);
+  }
+  for (auto &recv : inbox) {
+    stats.irecv(recv.source, recv.size);
+    handle_next_receive(recv.buffer, recv.size, recv.tag);
+  }
+  return !inbox.empty();
+}
+
+/**
+ * @brief Packs a message into the calling thread's own send buffers.  The
+ * buffers are coalesced into the shared send buffers once they exceed
+ * YGM_COMM_THREAD_BUFFER_SIZE_KB, or at local_progress() and barrier().
+ */
+template <typename AsyncFunction, typename... SendArgs>
+inline void comm::async_thread_buffered(int dest, AsyncFunction fn,
+                                        const SendArgs &...args) {
+  thread_send_buffers &tsb = local_thread_send_buffers();
+  if (m_tracer) {
+    m_tracer->instant(detail::event_tracer::event_type::async, dest);
+  }
+
+  if (tsb.async_counts[dest]++ == 0) {
+    tsb.async_dests.push_back(dest);
+  }
+  tsb.send_count++;
+
+  int next_dest = dest;
+  if (config.routing != detail::routing_type::NONE) {
+    next_dest = m_router.next_hop(dest);
+  }
+
+  ygm::detail::byte_vector &send_buff = tsb.buffers[next_dest];
+  if (send_buff.empty()) {
+    tsb.dests.push_back(next_dest);
+  }
+
+  size_t header_bytes = 0;
+  if (config.routing != detail::routing_type::NONE) {
+    header_bytes = pack_header(send_buff, dest, 0);
+  }
+
+  uint32_t bytes = pack_lambda(send_buff, nullptr, fn,
+                               std::forward<const SendArgs>(args)...);
+
+  if (config.routing != detail::routing_type::NONE) {
+    auto iter = send_buff.end();
+    iter -= (header_bytes + bytes);
+    std::memcpy(&*iter, &bytes, sizeof(header_t::dest));
+  }
+  tsb.bytes += header_bytes + bytes;
+
+  if (tsb.bytes > config.thread_buffer_size) {
+    async_lock_guard lock(this);
+    coalesce_thread_send_buffers(tsb);
+  }
+}
+
+/**
+ * @brief Finds (or registers) the send buffers of the calling thread
+ */
+inline comm::thread_send_buffers &comm::local_thread_send_buffers() {
+  thread_local uint64_t             cached_instance_id = 0;
+  thread_local thread_send_buffers *cached_tsb         = nullptr;
+  if (cached_instance_id != m_instance_id) {
+    async_lock_guard lock(this);
+    cached_tsb = nullptr;
+    for (auto &tsb : m_thread_send_buffers) {
+      if (tsb->owner == std::this_thread::get_id()) {
+        cached_tsb = tsb.get();
+      }
+    }
+    if (cached_tsb == nullptr) {
+      m_thread_send_buffers.push_back(std::make_unique<thread_send_buffers>());
+      cached_tsb        = m_thread_send_buffers.back().get();
+      cached_tsb->owner = std::this_thread::get_id();
+      cached_tsb->buffers.resize(m_layout.size());
+      cached_tsb->async_counts.resize(m_layout.size(), 0);
+    }
+    cached_instance_id = m_instance_id;
+  }
+  return *cached_tsb;
+}
+
+/**
+ * @brief Appends a thread's buffered messages to the shared send buffers.
+ * Must be called while holding the async lock.
+ */
+inline void comm::coalesce_thread_send_buffers(thread_send_buffers &tsb) {
+  if (tsb.dests.empty()) {
+    return;
+  }
+  for (int dest : tsb.async_dests) {
+    stats.async(dest, tsb.async_counts[dest]);
+    tsb.async_counts[dest] = 0;
+  }
+  tsb.async_dests.clear();
+  m_send_count += tsb.send_count;
+  tsb.send_count = 0;
+  tsb.bytes      = 0;
+
+  check_if_production_halt_required();
+
+  while (!tsb.dests.empty()) {
+    int dest = tsb.dests.front();
+    tsb.dests.pop_front();
+    ygm::detail::byte_vector &from = tsb.buffers[dest];
+    bool                      local = m_layout.is_local(dest);
+    if (m_vec_send_buffers[dest].empty()) {
+      queue_send_dest(dest);
+    }
+    m_vec_send_buffers[dest].push_bytes(from.data(), from.size());
+    if (local) {
+      m_send_local_buffer_bytes += from.size();
+    } else {
+      m_send_remote_buffer_bytes += from.size();
+    }
+    from.clear();
+  }
+
+  flush_to_capacity();
+}
+
+/**
+ * @brief Coalesces the send buffers of every thread.  Only valid outside of
+ * threaded regions, e.g. at barrier().
+ *
+ * @return True if any thread had buffered messages
+ */
+inline bool comm::coalesce_all_thread_send_buffers() {
+  bool coalesced = false;
+  for (auto &tsb : m_thread_send_buffers) {
+    if (!tsb->dests.empty()) {
+      coalesced = true;
+      coalesce_thread_send_buffers(*tsb);
+    }
+  }
+  return coalesced;
+}
+
+inline bool comm::holds_async_lock() const {
+  return m_async_lock_owner == std::this_thread::get_id();
+}
 };  // namespace ygm
@@ -10,13 +10,23 @@
 #include <sstream>
 #include <string>
 #include <cmath>
+#include <ygm/detail/byte_vector_pool.hpp>
 #include <ygm/detail/layout.hpp>
+#include <ygm/detail/mpi.hpp>
 
 namespace ygm {
 
 namespace detail {
 
-enum class routing_type { NONE, NR, NLNR };
+enum class routing_type { NONE, NR, NLNR, GRID };
+
+enum class compression_type { NONE, REMOTE, ALL };
+
+enum class traffic_stats_type { NONE, CSV, JSON };
+
+enum class archive_type { DEFAULT, COMPACT, DICTIONARY };
+
+using huge_page_type = byte_vector_pool::huge_page_type;
 
   size_t round_to_nearest_kb(float number) {
     return std::ceil(static_cast<float>(number) / 1024) * 1024;
@@ -32,7 +42,7 @@ class comm_environment {
    * @brief Converts char* to type T
    */
   template <typename T>
-  T convert(const char* str) {
+  static T convert(const char* str) {
     std::stringstream sstr;
     sstr << str;
     T to_return;
@@ -51,6 +61,8 @@ class comm_environment {
         routing = routing_type::NR;
       } else if (std::string(cc) == "NLNR") {
         routing = routing_type::NLNR;
+      } else if (std::string(cc) == "GRID") {
+        routing = routing_type::GRID;
       } else {
         throw std::runtime_error("comm_enviornment -- unknown routing type");
       }
@@ -63,6 +75,8 @@ class comm_environment {
     //      In high-node count situations, this will give roughly equal local and remote communication.
     // NLNR - Most remote messages generate one remote message and two local messages. In high node-count
     //      situations, this will give roughly 1/3 of communication as remote and 2/3 as local.
+    // GRID - Most remote messages generate two remote messages, along a row and a column of the node
+    //      grid, followed by a single local message, giving roughly 2/3 of communication as remote.
     if (const char* cc = std::getenv("YGM_COM_BUFFER_SIZE_KB")) {
       total_buffer_size = convert<size_t>(cc) * 1024;
     }
@@ -79,6 +93,10 @@ class comm_environment {
         local_buffer_size  = round_to_nearest_kb(2 * (float) total_buffer_size / 3);
         remote_buffer_size = round_to_nearest_kb((float) total_buffer_size / 3);
         break;
+      case routing_type::GRID :
+        local_buffer_size  = round_to_nearest_kb((float) total_buffer_size / 3);
+        remote_buffer_size = round_to_nearest_kb(2 * (float) total_buffer_size / 3);
+        break;
     }
     if (const char* cc = std::getenv("YGM_COMM_LOCAL_BUFFER_SIZE_KB")) {
       local_buffer_size = convert<size_t>(cc) * 1024;
@@ -108,16 +126,207 @@ class comm_environment {
     if (const char* cc = std::getenv("YGM_COMM_SEND_BUFFER_FREE_LIST_LEN")) {
       send_buffer_free_list_len = convert<size_t>(cc);
     }
+    if (const char* cc = std::getenv("YGM_COMM_PROGRESS_THREAD")) {
+      progress_thread = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_THREAD_SAFE_ASYNC")) {
+      thread_safe_async = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_THREAD_BUFFER_SIZE_KB")) {
+      thread_buffer_size = convert<size_t>(cc) * 1024;
+    }
+    if (const char* cc = std::getenv("YGM_COMM_PROBE_RECV")) {
+      probe_recv = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_PERSISTENT_RECV")) {
+      persistent_recv = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_SHM_TRANSPORT")) {
+      shm_transport = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_SHM_RING_SIZE_KB")) {
+      shm_ring_size = convert<size_t>(cc) * 1024;
+    }
+    if (const char* cc = std::getenv("YGM_COMM_RMA_TRANSPORT")) {
+      rma_transport = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_RMA_SLOTS")) {
+      rma_slots = convert<size_t>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_RMA_SLOT_SIZE_KB")) {
+      rma_slot_size = convert<size_t>(cc) * 1024;
+    }
+    if (const char* cc = std::getenv("YGM_COMM_ADAPTIVE_BUFFERS")) {
+      adaptive_buffers = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_MAX_BUFFER_AGE_US")) {
+      max_buffer_age_us = convert<size_t>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_BUFFER_POOL")) {
+      buffer_pool = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_BUFFER_POOL_MAX_MB")) {
+      buffer_pool_max_size = convert<size_t>(cc) * 1024 * 1024;
+    }
+    if (const char* cc = std::getenv("YGM_COMM_HUGE_PAGES")) {
+      if (std::string(cc) == "none") {
+        huge_pages = huge_page_type::NONE;
+      } else if (std::string(cc) == "thp") {
+        huge_pages = huge_page_type::THP;
+      } else if (std::string(cc) == "hugetlb") {
+        huge_pages = huge_page_type::HUGETLB;
+      } else {
+        throw std::runtime_error("comm_enviornment -- unknown huge page type");
+      }
+    }
+    if (const char* cc = std::getenv("YGM_COMM_ROUTE_COMBINE")) {
+      route_combine = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_AGGREGATE_HANDLERS")) {
+      aggregate_handlers = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_COMPRESS")) {
+      if (std::string(cc) == "none") {
+        compress = compression_type::NONE;
+      } else if (std::string(cc) == "remote") {
+        compress = compression_type::REMOTE;
+      } else if (std::string(cc) == "all") {
+        compress = compression_type::ALL;
+      } else {
+        throw std::runtime_error("comm_enviornment -- unknown compression type");
+      }
+    }
+    if (const char* cc = std::getenv("YGM_COMM_COMPRESS_MIN_SIZE_KB")) {
+      compress_min_size = convert<size_t>(cc) * 1024;
+    }
+    if (const char* cc = std::getenv("YGM_COMM_ARCHIVE")) {
+      if (std::string(cc) == "default") {
+        archive = archive_type::DEFAULT;
+      } else if (std::string(cc) == "compact") {
+        archive = archive_type::COMPACT;
+      } else if (std::string(cc) == "dictionary") {
+        archive = archive_type::DICTIONARY;
+      } else {
+        throw std::runtime_error("comm_enviornment -- unknown archive type");
+      }
+    }
+    if (const char* cc = std::getenv("YGM_COMM_TRACE_FILE")) {
+      trace_file = cc;
+    }
+    if (const char* cc = std::getenv("YGM_COMM_TRACE_EVENTS")) {
+      trace_events = convert<size_t>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_PROFILE_HANDLERS")) {
+      profile_handlers = convert<bool>(cc);
+    }
+    if (const char* cc = std::getenv("YGM_COMM_TRAFFIC_STATS")) {
+      if (std::string(cc) == "none") {
+        traffic_stats = traffic_stats_type::NONE;
+      } else if (std::string(cc) == "csv") {
+        traffic_stats = traffic_stats_type::CSV;
+      } else if (std::string(cc) == "json") {
+        traffic_stats = traffic_stats_type::JSON;
+      } else {
+        throw std::runtime_error("comm_enviornment -- unknown traffic stats format");
+      }
+    }
+  }
+
+  /**
+   * @brief MPI thread support required by the environment settings.
+   * Static because it must be known before MPI_Init is called.
+   */
+  static int required_thread_level() {
+    if (const char* cc = std::getenv("YGM_COMM_PROGRESS_THREAD")) {
+      if (convert<bool>(cc)) {
+        return MPI_THREAD_MULTIPLE;
+      }
+    }
+    if (const char* cc = std::getenv("YGM_COMM_THREAD_SAFE_ASYNC")) {
+      if (convert<bool>(cc)) {
+        return MPI_THREAD_SERIALIZED;
+      }
+    }
+    return MPI_THREAD_SINGLE;
   }
 
   void print(std::ostream& os = std::cout) const {
     os << "======== ENVIRONMENT SETTINGS ========\n"
        << "YGM_COMM_LOCAL_BUFFER_SIZE_KB   = " << local_buffer_size / 1024 << "\n"
        << "YGM_COMM_REMOTE_BUFFER_SIZE_KB  = " << remote_buffer_size / 1024 << "\n"
-       << "YGM_COMM_NUM_IRECVS             = " << num_irecvs << "\n"
+       << "YGM_COMM_ADAPTIVE_BUFFERS       = " << adaptive_buffers << "\n"
+       << "YGM_COMM_MAX_BUFFER_AGE_US      = " << max_buffer_age_us << "\n"
+       << "YGM_COMM_AGGREGATE_HANDLERS     = " << aggregate_handlers << "\n"
+       << "YGM_COMM_ROUTE_COMBINE          = " << route_combine << "\n"
+       << "YGM_COMM_BUFFER_POOL            = " << buffer_pool << "\n"
+       << "YGM_COMM_BUFFER_POOL_MAX_MB     = "
+       << buffer_pool_max_size / (1024 * 1024) << "\n"
+       << "YGM_COMM_HUGE_PAGES             = ";
+    switch (huge_pages) {
+      case huge_page_type::NONE:
+        os << "none\n";
+        break;
+      case huge_page_type::THP:
+        os << "thp\n";
+        break;
+      case huge_page_type::HUGETLB:
+        os << "hugetlb\n";
+        break;
+    }
+    os << "YGM_COMM_NUM_IRECVS             = " << num_irecvs << "\n"
        << "YGM_COMM_IRECVS_SIZE_KB         = " << irecv_size / 1024 << "\n"
+       << "YGM_COMM_PROBE_RECV             = " << probe_recv << "\n"
+       << "YGM_COMM_PERSISTENT_RECV        = " << persistent_recv << "\n"
        << "YGM_COMM_NUM_ISENDS_WAIT        = " << num_isends_wait << "\n"
        << "YGM_COMM_ISSEND_FREQ            = " << freq_issend << "\n"
+       << "YGM_COMM_PROGRESS_THREAD        = " << progress_thread << "\n"
+       << "YGM_COMM_THREAD_SAFE_ASYNC      = " << thread_safe_async << "\n"
+       << "YGM_COMM_THREAD_BUFFER_SIZE_KB  = " << thread_buffer_size / 1024 << "\n"
+       << "YGM_COMM_SHM_TRANSPORT          = " << shm_transport << "\n"
+       << "YGM_COMM_SHM_RING_SIZE_KB       = " << shm_ring_size / 1024 << "\n"
+       << "YGM_COMM_RMA_TRANSPORT          = " << rma_transport << "\n"
+       << "YGM_COMM_RMA_SLOTS              = " << rma_slots << "\n"
+       << "YGM_COMM_RMA_SLOT_SIZE_KB       = " << rma_slot_size / 1024 << "\n"
+       << "YGM_COMM_COMPRESS               = ";
+    switch (compress) {
+      case compression_type::NONE:
+        os << "none\n";
+        break;
+      case compression_type::REMOTE:
+        os << "remote\n";
+        break;
+      case compression_type::ALL:
+        os << "all\n";
+        break;
+    }
+    os << "YGM_COMM_COMPRESS_MIN_SIZE_KB   = " << compress_min_size / 1024 << "\n"
+       << "YGM_COMM_ARCHIVE                = ";
+    switch (archive) {
+      case archive_type::DEFAULT:
+        os << "default\n";
+        break;
+      case archive_type::COMPACT:
+        os << "compact\n";
+        break;
+      case archive_type::DICTIONARY:
+        os << "dictionary\n";
+        break;
+    }
+    os << "YGM_COMM_TRAFFIC_STATS          = ";
+    switch (traffic_stats) {
+      case traffic_stats_type::NONE:
+        os << "none\n";
+        break;
+      case traffic_stats_type::CSV:
+        os << "csv\n";
+        break;
+      case traffic_stats_type::JSON:
+        os << "json\n";
+        break;
+    }
+    os << "YGM_COMM_PROFILE_HANDLERS       = " << profile_handlers << "\n"
+       << "YGM_COMM_TRACE_FILE             = " << trace_file << "\n"
+       << "YGM_COMM_TRACE_EVENTS           = " << trace_events << "\n"
        << "YGM_COMM_ROUTING                = ";
     switch (routing) {
       case routing_type::NONE:
@@ -129,6 +338,9 @@ class comm_environment {
       case routing_type::NLNR:
         os << "NLNR\n";
         break;
+      case routing_type::GRID:
+        os << "GRID\n";
+        break;
     }
     os << "======================================\n";
   }
@@ -138,9 +350,28 @@ class comm_environment {
   size_t total_buffer_size = 16 * 1024 * 1024;
   size_t local_buffer_size;
   size_t remote_buffer_size;
+  bool   adaptive_buffers = false;
+
+  // Buffers older than this are flushed during progress, 0 disables
+  size_t max_buffer_age_us = 0;
+
+  bool aggregate_handlers = false;
+
+  // Forwarding ranks merge messages with a registered route combiner.  Opt-in,
+  // as merged messages are forwarded after the rest of their receive buffer,
+  // so they lose their order relative to other messages from the same source.
+  bool route_combine = false;
+
+  bool           buffer_pool          = false;
+  size_t         buffer_pool_max_size = 256 * 1024 * 1024;
+  huge_page_type huge_pages           = huge_page_type::NONE;
 
   size_t irecv_size = 1024 * 1024 * 1024;
   size_t num_irecvs = 8;
+  bool   probe_recv = false;
+  // Reuse MPI_Recv_init requests instead of posting a new MPI_Irecv, ignored
+  // with probe_recv
+  bool persistent_recv = false;
 
   size_t num_isends_wait           = 4;
   size_t freq_issend               = 8;
@@ -148,6 +379,36 @@ class comm_environment {
 
   routing_type routing = routing_type::NONE;
 
+  bool progress_thread = false;
+
+  bool   thread_safe_async  = false;
+  size_t thread_buffer_size = 256 * 1024;
+
+  // On-node buffers go through shared memory rings.  Buffers that do not fit
+  // wait behind the ring, and a dest only falls back to MPI once its ring has
+  // drained, staying on MPI until the next barrier so order is kept.
+  bool   shm_transport = false;
+  size_t shm_ring_size = 256 * 1024;
+
+  // Buffers are put into receive slots, dispatched in send order per sender.
+  // Falls back to MPI the same way as shm_transport.
+  bool   rma_transport = false;
+  size_t rma_slots     = 8;
+  size_t rma_slot_size = 512 * 1024;
+
+  compression_type compress          = compression_type::NONE;
+  size_t           compress_min_size = 4 * 1024;
+
+  archive_type archive = archive_type::DEFAULT;
+
+  traffic_stats_type traffic_stats    = traffic_stats_type::NONE;
+  bool               profile_handlers = false;
+
+  // Events from the application, async() calling and progress threads are
+  // written per rank to <trace_file>.<rank>.json, each thread as its own tid
+  std::string trace_file;
+  size_t      trace_events = 1024 * 1024;
+
   bool welcome = false;
 };
 
@@ -7,6 +7,7 @@
 
 #include <ygm/detail/comm_environment.hpp>
 #include <ygm/detail/layout.hpp>
+#include <ygm/detail/node_grid.hpp>
 
 namespace ygm {
 
@@ -18,7 +19,7 @@ namespace detail {
 class comm_router {
  public:
   comm_router(const layout &l, const routing_type route = routing_type::NONE)
-      : m_layout(l), m_default_route(route) {}
+      : m_layout(l), m_default_route(route), m_grid(l.node_size()) {}
 
   /**
    * @brief Calculates the next hop based on the given routing scheme and final
@@ -33,6 +34,9 @@ class comm_router {
    * remote hop, followed by an on-node hop
    * 4. The pairs of remote processes communicating in routing_type::NLNR is a
    * subset of those communicating in routing_type::NR
+   * 5. routing_type::GRID makes at most 3 hops, a remote hop along a row of
+   * the node grid, a remote hop along a column and an on-node hop.  Each
+   * remote hop keeps the local rank, as in routing_type::NR.
    */
   int next_hop(const int dest, const routing_type route) const {
     int to_return;
@@ -65,6 +69,15 @@ class comm_router {
           }
         }
         break;
+      case routing_type::GRID:
+        if (m_layout.is_local(dest)) {
+          to_return = dest;
+        } else {
+          int next_node =
+              m_grid.next_node(m_layout.node_id(), m_layout.node_id(dest));
+          to_return = m_layout.strided_ranks()[next_node];
+        }
+        break;
       default:
         std::cerr << "Unknown routing type" << std::endl;
         return -1;
@@ -78,6 +91,7 @@ class comm_router {
  private:
   routing_type  m_default_route;
   const layout &m_layout;
+  node_grid     m_grid;
 };
 
 }  // namespace detail
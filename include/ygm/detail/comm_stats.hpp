@@ -6,9 +6,33 @@
 #pragma once
 
 #include <mpi.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
 
 namespace ygm {
 namespace detail {
+
+/**
+ * @brief Histogram with power-of-two buckets.  Bucket 0 counts zeros and
+ * bucket k counts values in [2^(k-1), 2^k).
+ */
+class log2_histogram {
+ public:
+  static constexpr size_t num_buckets = 65;
+
+  void add(uint64_t value) { m_counts[std::bit_width(value)] += 1; }
+
+  void reset() { m_counts.fill(0); }
+
+  const std::array<uint64_t, num_buckets> &counts() const { return m_counts; }
+
+ private:
+  std::array<uint64_t, num_buckets> m_counts{};
+};
+
 class comm_stats {
  public:
   class timer {
@@ -24,9 +48,22 @@ class comm_stats {
 
   comm_stats() : m_time_start(MPI_Wtime()) {}
 
+  /**
+   * @brief Enables per-destination traffic counters and histograms
+   */
+  void enable_traffic(int num_ranks) {
+    m_dest_async_count.assign(num_ranks, 0);
+    m_dest_flush_count.assign(num_ranks, 0);
+    m_dest_flush_bytes.assign(num_ranks, 0);
+    m_dest_route_count.assign(num_ranks, 0);
+  }
+
+  bool traffic_enabled() const { return !m_dest_async_count.empty(); }
+
   void isend(int dest, size_t bytes) {
     m_isend_count += 1;
     m_isend_bytes += bytes;
+    flush(dest, bytes);
   }
 
   void irecv(int source, size_t bytes) {
@@ -34,11 +71,80 @@ class comm_stats {
     m_irecv_bytes += bytes;
   }
 
-  void async(int dest) { m_async_count += 1; }
+  void shm_send(int dest, size_t bytes) {
+    m_shm_send_count += 1;
+    m_shm_send_bytes += bytes;
+    flush(dest, bytes);
+  }
+
+  void rma_send(int dest, size_t bytes) {
+    m_rma_send_count += 1;
+    m_rma_send_bytes += bytes;
+    flush(dest, bytes);
+  }
+
+  void compressed(size_t raw_bytes, size_t compressed_bytes) {
+    m_compress_count += 1;
+    m_compress_raw_bytes += raw_bytes;
+    m_compress_bytes += compressed_bytes;
+  }
+
+  void adaptive_flush() { m_adaptive_flush_count += 1; }
+
+  void urgent_flush() { m_urgent_flush_count += 1; }
+
+  void age_flush() { m_age_flush_count += 1; }
+
+  void route_combine() { m_route_combine_count += 1; }
+
+  /**
+   * @brief Records how long a flushed buffer held its oldest message
+   */
+  void buffer_age(double seconds) {
+    uint64_t age_us = uint64_t(seconds * 1e6);
+    m_buffer_age_us_histogram.add(age_us);
+    m_max_buffer_age_us = std::max(m_max_buffer_age_us, age_us);
+  }
+
+  void async(int dest, size_t count = 1) {
+    m_async_count += count;
+    if (traffic_enabled()) {
+      m_dest_async_count[dest] += count;
+    }
+  }
 
   void rpc_execute() { m_rpc_count += 1; }
 
-  void routing() { m_route_count += 1; }
+  void enable_handler_profile() { m_handler_profile = true; }
+
+  bool handler_profile_enabled() const { return m_handler_profile; }
+
+  /**
+   * @brief Records one handler execution for the traffic histogram and, when
+   * profiling, for the handler's lambda_map id
+   */
+  void handler(uint16_t lid, size_t bytes, double seconds) {
+    if (traffic_enabled()) {
+      m_handler_time_ns_histogram.add(uint64_t(seconds * 1e9));
+    }
+    if (m_handler_profile) {
+      if (lid >= m_handler_calls.size()) {
+        m_handler_calls.resize(lid + 1, 0);
+        m_handler_bytes.resize(lid + 1, 0);
+        m_handler_times.resize(lid + 1, 0.0);
+      }
+      m_handler_calls[lid] += 1;
+      m_handler_bytes[lid] += bytes;
+      m_handler_times[lid] += seconds;
+    }
+  }
+
+  void routing(int dest) {
+    m_route_count += 1;
+    if (traffic_enabled()) {
+      m_dest_route_count[dest] += 1;
+    }
+  }
 
   void isend_test() { m_isend_test_count += 1; }
 
@@ -56,6 +162,10 @@ class comm_stats {
     return timer(m_waitsome_iallreduce_time);
   }
 
+  timer compress() { return timer(m_compress_time); }
+
+  timer decompress() { return timer(m_decompress_time); }
+
   void reset() {
     m_async_count                = 0;
     m_rpc_count                  = 0;
@@ -66,6 +176,30 @@ class comm_stats {
     m_irecv_count                = 0;
     m_irecv_bytes                = 0;
     m_irecv_test_count           = 0;
+    m_shm_send_count             = 0;
+    m_shm_send_bytes             = 0;
+    m_rma_send_count             = 0;
+    m_rma_send_bytes             = 0;
+    m_adaptive_flush_count       = 0;
+    m_urgent_flush_count         = 0;
+    m_age_flush_count            = 0;
+    m_route_combine_count        = 0;
+    m_max_buffer_age_us          = 0;
+    m_buffer_age_us_histogram.reset();
+    std::fill(m_dest_async_count.begin(), m_dest_async_count.end(), 0);
+    std::fill(m_dest_flush_count.begin(), m_dest_flush_count.end(), 0);
+    std::fill(m_dest_flush_bytes.begin(), m_dest_flush_bytes.end(), 0);
+    std::fill(m_dest_route_count.begin(), m_dest_route_count.end(), 0);
+    m_flush_size_histogram.reset();
+    m_handler_calls.clear();
+    m_handler_bytes.clear();
+    m_handler_times.clear();
+    m_handler_time_ns_histogram.reset();
+    m_compress_count             = 0;
+    m_compress_raw_bytes         = 0;
+    m_compress_bytes             = 0;
+    m_compress_time              = 0.0f;
+    m_decompress_time            = 0.0f;
     m_waitsome_isend_irecv_time  = 0.0f;
     m_waitsome_isend_irecv_count = 0.0f;
     m_iallreduce_count           = 0;
@@ -86,6 +220,54 @@ class comm_stats {
   size_t get_irecv_bytes() const { return m_irecv_bytes; }
   size_t get_irecv_test_count() const { return m_irecv_test_count; }
 
+  size_t get_shm_send_count() const { return m_shm_send_count; }
+  size_t get_shm_send_bytes() const { return m_shm_send_bytes; }
+  size_t get_rma_send_count() const { return m_rma_send_count; }
+  size_t get_rma_send_bytes() const { return m_rma_send_bytes; }
+
+  size_t get_adaptive_flush_count() const { return m_adaptive_flush_count; }
+  size_t get_urgent_flush_count() const { return m_urgent_flush_count; }
+  size_t get_age_flush_count() const { return m_age_flush_count; }
+  size_t get_route_combine_count() const { return m_route_combine_count; }
+  size_t get_max_buffer_age_us() const { return m_max_buffer_age_us; }
+  const log2_histogram &get_buffer_age_us_histogram() const {
+    return m_buffer_age_us_histogram;
+  }
+
+  const std::vector<uint64_t> &get_dest_async_count() const {
+    return m_dest_async_count;
+  }
+  const std::vector<uint64_t> &get_dest_flush_count() const {
+    return m_dest_flush_count;
+  }
+  const std::vector<uint64_t> &get_dest_flush_bytes() const {
+    return m_dest_flush_bytes;
+  }
+  const std::vector<uint64_t> &get_dest_route_count() const {
+    return m_dest_route_count;
+  }
+  const std::vector<size_t> &get_handler_calls() const {
+    return m_handler_calls;
+  }
+  const std::vector<size_t> &get_handler_bytes() const {
+    return m_handler_bytes;
+  }
+  const std::vector<double> &get_handler_times() const {
+    return m_handler_times;
+  }
+  const log2_histogram &get_flush_size_histogram() const {
+    return m_flush_size_histogram;
+  }
+  const log2_histogram &get_handler_time_ns_histogram() const {
+    return m_handler_time_ns_histogram;
+  }
+
+  size_t get_compress_count() const { return m_compress_count; }
+  size_t get_compress_raw_bytes() const { return m_compress_raw_bytes; }
+  size_t get_compress_bytes() const { return m_compress_bytes; }
+  double get_compress_time() const { return m_compress_time; }
+  double get_decompress_time() const { return m_decompress_time; }
+
   double get_waitsome_isend_irecv_time() const {
     return m_waitsome_isend_irecv_time;
   }
@@ -104,6 +286,14 @@ class comm_stats {
   double get_elapsed_time() const { return MPI_Wtime() - m_time_start; }
 
  private:
+  void flush(int dest, size_t bytes) {
+    if (traffic_enabled()) {
+      m_dest_flush_count[dest] += 1;
+      m_dest_flush_bytes[dest] += bytes;
+      m_flush_size_histogram.add(bytes);
+    }
+  }
+
   size_t m_async_count = 0;
   size_t m_rpc_count   = 0;
   size_t m_route_count = 0;
@@ -116,6 +306,41 @@ class comm_stats {
   size_t m_irecv_bytes      = 0;
   size_t m_irecv_test_count = 0;
 
+  size_t m_shm_send_count = 0;
+  size_t m_shm_send_bytes = 0;
+
+  size_t m_rma_send_count = 0;
+  size_t m_rma_send_bytes = 0;
+
+  size_t m_adaptive_flush_count = 0;
+  size_t m_urgent_flush_count   = 0;
+  size_t m_route_combine_count  = 0;
+
+  // Filled only while YGM_COMM_MAX_BUFFER_AGE_US is set
+  size_t         m_age_flush_count   = 0;
+  uint64_t       m_max_buffer_age_us = 0;
+  log2_histogram m_buffer_age_us_histogram;
+
+  // Per-destination traffic, empty unless enable_traffic() was called
+  std::vector<uint64_t> m_dest_async_count;
+  std::vector<uint64_t> m_dest_flush_count;
+  std::vector<uint64_t> m_dest_flush_bytes;
+  std::vector<uint64_t> m_dest_route_count;
+  log2_histogram        m_flush_size_histogram;
+  log2_histogram        m_handler_time_ns_histogram;
+
+  // Per-handler profile indexed by lambda_map id
+  bool                m_handler_profile = false;
+  std::vector<size_t> m_handler_calls;
+  std::vector<size_t> m_handler_bytes;
+  std::vector<double> m_handler_times;
+
+  size_t m_compress_count     = 0;
+  size_t m_compress_raw_bytes = 0;
+  size_t m_compress_bytes     = 0;
+  double m_compress_time      = 0.0f;
+  double m_decompress_time    = 0.0f;
+
   double m_waitsome_isend_irecv_time  = 0.0f;
   size_t m_waitsome_isend_irecv_count = 0.0f;
 
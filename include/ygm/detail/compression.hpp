@@ -0,0 +1,195 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <ygm/detail/assert.hpp>
+#include <ygm/detail/byte_vector.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Fast LZ77 block codec used to compress send buffers.
+ *
+ * The format follows LZ4's sequence layout: each sequence is a token holding
+ * 4-bit literal and match lengths, extended literal length, literals, a 16-bit
+ * match offset and extended match length.  The last sequence holds only
+ * literals.  Blocks are prefixed by their uncompressed size.
+ */
+class lz_codec {
+  static constexpr size_t   min_match  = 4;
+  static constexpr size_t   max_offset = 65535;
+  static constexpr uint32_t hash_bits  = 12;
+
+ public:
+  /**
+   * @brief Compresses size bytes of src into out
+   *
+   * @return Compressed size, or 0 if the block did not shrink
+   */
+  size_t compress(const std::byte *src, size_t size, byte_vector &out) {
+    out.resize(sizeof(uint64_t) + size + size / 255 + 16);
+    std::byte *op     = out.data();
+    std::byte *op_end = op + size;  // give up once output is not smaller
+    uint64_t   size64 = size;
+    std::memcpy(op, &size64, sizeof(uint64_t));
+    op += sizeof(uint64_t);
+
+    m_table.assign(size_t(1) << hash_bits, 0);
+    size_t anchor = 0;
+    size_t i      = 0;
+    while (i + min_match <= size) {
+      uint32_t v    = load32(src + i);
+      uint32_t h    = hash(v);
+      size_t   cand = m_table[h];
+      m_table[h]    = i + 1;
+      if (cand == 0 || i - (cand - 1) > max_offset ||
+          load32(src + cand - 1) != v) {
+        ++i;
+        continue;
+      }
+      size_t match = cand - 1;
+      size_t len   = min_match;
+      while (i + len < size && src[match + len] == src[i + len]) {
+        ++len;
+      }
+      op = write_sequence(op, src + anchor, i - anchor, i - match, len);
+      if (op >= op_end) {
+        return 0;
+      }
+      i += len;
+      anchor = i;
+    }
+    op = write_literals(op, src + anchor, size - anchor);
+    if (op >= op_end) {
+      return 0;
+    }
+    out.resize(op - out.data());
+    return out.size();
+  }
+
+  /**
+   * @brief Uncompressed size of a block produced by compress()
+   */
+  static size_t decompressed_size(const std::byte *src) {
+    uint64_t size64;
+    std::memcpy(&size64, src, sizeof(uint64_t));
+    return size64;
+  }
+
+  /**
+   * @brief Decompresses a block into out, which must have room for
+   * decompressed_size(src) bytes
+   */
+  static void decompress(const std::byte *src, size_t size, std::byte *out) {
+    const std::byte *ip      = src + sizeof(uint64_t);
+    const std::byte *ip_end  = src + size;
+    std::byte       *op      = out;
+    std::byte       *op_end  = out + decompressed_size(src);
+    while (true) {
+      YGM_ASSERT_RELEASE(ip < ip_end);
+      uint8_t token   = uint8_t(*ip++);
+      size_t  lit_len = read_length(ip, ip_end, token >> 4);
+      YGM_ASSERT_RELEASE(lit_len <= size_t(ip_end - ip) &&
+                         lit_len <= size_t(op_end - op));
+      std::memcpy(op, ip, lit_len);
+      ip += lit_len;
+      op += lit_len;
+      if (op == op_end) {
+        break;
+      }
+      YGM_ASSERT_RELEASE(ip + 2 <= ip_end);
+      size_t offset = size_t(uint8_t(ip[0])) | (size_t(uint8_t(ip[1])) << 8);
+      ip += 2;
+      size_t len = read_length(ip, ip_end, token & 0x0F) + min_match;
+      YGM_ASSERT_RELEASE(offset > 0 && offset <= size_t(op - out) &&
+                         len <= size_t(op_end - op));
+      const std::byte *match = op - offset;
+      if (offset >= len) {
+        std::memcpy(op, match, len);
+        op += len;
+      } else {
+        // Overlapping match repeats the last offset bytes
+        for (size_t j = 0; j < len; ++j) {
+          *op++ = *match++;
+        }
+      }
+    }
+  }
+
+ private:
+  static uint32_t load32(const std::byte *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static uint32_t hash(uint32_t v) {
+    return (v * 2654435761u) >> (32 - hash_bits);
+  }
+
+  static std::byte *write_length(std::byte *op, size_t len) {
+    while (len >= 255) {
+      *op++ = std::byte(255);
+      len -= 255;
+    }
+    *op++ = std::byte(len);
+    return op;
+  }
+
+  static size_t read_length(const std::byte *&ip, const std::byte *ip_end,
+                            size_t nibble) {
+    size_t len = nibble;
+    if (nibble == 15) {
+      uint8_t b;
+      do {
+        YGM_ASSERT_RELEASE(ip < ip_end);
+        b = uint8_t(*ip++);
+        len += b;
+      } while (b == 255);
+    }
+    return len;
+  }
+
+  static std::byte *write_sequence(std::byte *op, const std::byte *lit,
+                                   size_t lit_len, size_t offset,
+                                   size_t match_len) {
+    size_t ml    = match_len - min_match;
+    *op++        = std::byte(((lit_len < 15 ? lit_len : 15) << 4) |
+                             (ml < 15 ? ml : 15));
+    if (lit_len >= 15) {
+      op = write_length(op, lit_len - 15);
+    }
+    std::memcpy(op, lit, lit_len);
+    op += lit_len;
+    *op++ = std::byte(offset & 0xFF);
+    *op++ = std::byte(offset >> 8);
+    if (ml >= 15) {
+      op = write_length(op, ml - 15);
+    }
+    return op;
+  }
+
+  static std::byte *write_literals(std::byte *op, const std::byte *lit,
+                                   size_t lit_len) {
+    *op++ = std::byte((lit_len < 15 ? lit_len : 15) << 4);
+    if (lit_len >= 15) {
+      op = write_length(op, lit_len - 15);
+    }
+    std::memcpy(op, lit, lit_len);
+    return op + lit_len;
+  }
+
+  std::vector<uint32_t> m_table;
+};
+
+}  // namespace detail
+}  // namespace ygm
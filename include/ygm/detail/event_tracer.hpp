@@ -0,0 +1,197 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <ygm/detail/mpi.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Records timestamped comm events into a fixed-size ring and writes
+ * them out in Chrome trace format (viewable in chrome://tracing or Perfetto).
+ *
+ * Slots are claimed with a single atomic increment, so the progress thread
+ * and threads calling async() under YGM_COMM_THREAD_SAFE_ASYNC can record
+ * alongside the application thread.  Each recording thread gets its own tid
+ * in the trace.  Once the ring is full the oldest events are overwritten.
+ */
+class event_tracer {
+ public:
+  enum class event_type : uint8_t {
+    async,
+    flush,
+    recv_buffer,
+    handler,
+    barrier_round,
+    iallreduce_wait,
+    progress
+  };
+
+  /**
+   * @brief Records a complete event when it goes out of scope
+   */
+  class scope {
+   public:
+    scope(event_tracer *t, event_type type, int64_t arg0 = 0,
+          int64_t arg1 = 0)
+        : m_tracer(t),
+          m_type(type),
+          m_arg0(arg0),
+          m_arg1(arg1),
+          m_start(t ? MPI_Wtime() : 0.0) {}
+
+    ~scope() {
+      if (m_tracer) {
+        m_tracer->complete(m_type, m_start, m_arg0, m_arg1);
+      }
+    }
+
+    void set_args(int64_t arg0, int64_t arg1) {
+      m_arg0 = arg0;
+      m_arg1 = arg1;
+    }
+
+   private:
+    event_tracer *m_tracer;
+    event_type    m_type;
+    int64_t       m_arg0;
+    int64_t       m_arg1;
+    double        m_start;
+  };
+
+  event_tracer(size_t capacity)
+      : m_events(capacity), m_time_start(MPI_Wtime()) {}
+
+  void instant(event_type type, int64_t arg0 = 0, int64_t arg1 = 0) {
+    record({type, true, 0, MPI_Wtime(), 0.0, arg0, arg1});
+  }
+
+  void complete(event_type type, double start, int64_t arg0 = 0,
+                int64_t arg1 = 0) {
+    record({type, false, 0, start, MPI_Wtime() - start, arg0, arg1});
+  }
+
+  /**
+   * @brief Writes recorded events, oldest first, as a Chrome trace JSON object
+   */
+  void write_chrome_trace(std::ostream &os, int rank) const {
+    uint64_t end   = m_next.load();
+    uint64_t begin = end > m_events.size() ? end - m_events.size() : 0;
+    os << "{\"traceEvents\":[";
+    for (uint64_t i = begin; i < end; ++i) {
+      const event &e = m_events[i % m_events.size()];
+      os << (i > begin ? ",\n" : "\n") << "{\"name\":\"" << name(e.type)
+         << "\",\"cat\":\"ygm\",\"pid\":" << rank << ",\"tid\":" << e.tid << ",\"ts\":"
+         << (e.start - m_time_start) * 1e6;
+      if (e.instant) {
+        os << ",\"ph\":\"i\",\"s\":\"t\"";
+      } else {
+        os << ",\"ph\":\"X\",\"dur\":" << e.duration * 1e6;
+      }
+      os << ",\"args\":{\"" << arg0_name(e.type) << "\":" << e.arg0;
+      if (arg1_name(e.type)) {
+        os << ",\"" << arg1_name(e.type) << "\":" << e.arg1;
+      }
+      os << "}}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+       << begin << "}}\n";
+  }
+
+  size_t size() const {
+    return std::min<uint64_t>(m_next.load(), m_events.size());
+  }
+
+ private:
+  struct event {
+    event_type type;
+    bool       instant;
+    uint32_t   tid;
+    double     start;
+    double     duration;
+    int64_t    arg0;
+    int64_t    arg1;
+  };
+
+  void record(event e) {
+    e.tid         = thread_index();
+    uint64_t slot = m_next.fetch_add(1, std::memory_order_relaxed);
+    m_events[slot % m_events.size()] = e;
+  }
+
+  static uint32_t thread_index() {
+    static std::atomic<uint32_t> next_index = 0;
+    thread_local uint32_t        index      = next_index++;
+    return index;
+  }
+
+  static const char *name(event_type type) {
+    switch (type) {
+      case event_type::async:
+        return "async";
+      case event_type::flush:
+        return "flush";
+      case event_type::recv_buffer:
+        return "recv_buffer";
+      case event_type::handler:
+        return "handler";
+      case event_type::barrier_round:
+        return "barrier_round";
+      case event_type::iallreduce_wait:
+        return "iallreduce_wait";
+      case event_type::progress:
+        return "progress";
+    }
+    return "unknown";
+  }
+
+  static const char *arg0_name(event_type type) {
+    switch (type) {
+      case event_type::async:
+      case event_type::flush:
+        return "dest";
+      case event_type::recv_buffer:
+        return "bytes";
+      case event_type::handler:
+        return "lid";
+      case event_type::barrier_round:
+        return "global_recv_count";
+      case event_type::iallreduce_wait:
+        return "round";
+      case event_type::progress:
+        return "isends";
+    }
+    return "arg0";
+  }
+
+  static const char *arg1_name(event_type type) {
+    switch (type) {
+      case event_type::flush:
+      case event_type::handler:
+        return "bytes";
+      case event_type::barrier_round:
+        return "global_send_count";
+      case event_type::progress:
+        return "irecvs";
+      default:
+        return nullptr;
+    }
+  }
+
+  std::vector<event>    m_events;
+  std::atomic<uint64_t> m_next = 0;
+  double                m_time_start;
+};
+
+}  // namespace detail
+}  // namespace ygm
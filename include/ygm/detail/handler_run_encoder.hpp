@@ -0,0 +1,108 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <ygm/detail/byte_vector.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Coalesces consecutive messages to a destination that share a handler
+ * id into runs.
+ *
+ * A message is packed as [lid][payload].  Once a second message with the same
+ * lid directly follows the first, the pair is rewritten as
+ * [run_marker][lid][count][payload][payload] and every further message with
+ * that lid only appends its payload.  Receivers read the lid once and execute
+ * the whole run in a loop.
+ */
+class handler_run_encoder {
+ public:
+  using lid_type   = uint16_t;
+  using count_type = uint32_t;
+
+  /// lambda_map never assigns this id to a handler
+  static constexpr lid_type run_marker = std::numeric_limits<lid_type>::max();
+
+  static constexpr size_t run_header_size =
+      2 * sizeof(lid_type) + sizeof(count_type);
+
+  handler_run_encoder(int num_dests) : m_runs(num_dests) {}
+
+  /**
+   * @brief Folds the message just packed at offset into an open run
+   *
+   * @return Change in the size of buffer, which may be negative
+   */
+  ptrdiff_t append(byte_vector &buffer, int dest, size_t offset) {
+    run     &r = m_runs[dest];
+    lid_type lid;
+    std::memcpy(&lid, buffer.data() + offset, sizeof(lid_type));
+
+    if (r.count == 0 || r.end != offset || r.lid != lid ||
+        r.count == std::numeric_limits<count_type>::max()) {
+      r.lid    = lid;
+      r.offset = offset;
+      r.count  = 1;
+      r.end    = buffer.size();
+      return 0;
+    }
+
+    size_t    payload = buffer.size() - offset - sizeof(lid_type);
+    ptrdiff_t delta   = 0;
+    if (r.count == 1) {
+      // Open the run by inserting a header in front of the first message
+      size_t first = offset - r.offset - sizeof(lid_type);
+      delta        = run_header_size - 2 * sizeof(lid_type);
+      buffer.resize(buffer.size() + delta);
+      std::byte *base = buffer.data() + r.offset;
+      std::memmove(base + run_header_size + first,
+                   base + 2 * sizeof(lid_type) + first, payload);
+      std::memmove(base + run_header_size, base + sizeof(lid_type), first);
+      std::memcpy(base, &run_marker, sizeof(lid_type));
+      std::memcpy(base + sizeof(lid_type), &lid, sizeof(lid_type));
+    } else {
+      std::byte *message = buffer.data() + offset;
+      std::memmove(message, message + sizeof(lid_type), payload);
+      delta = -ptrdiff_t(sizeof(lid_type));
+      buffer.resize(buffer.size() + delta);
+    }
+    ++r.count;
+    std::memcpy(buffer.data() + r.offset + 2 * sizeof(lid_type), &r.count,
+                sizeof(count_type));
+    r.end = buffer.size();
+    ++m_aggregated_count;
+    return delta;
+  }
+
+  /**
+   * @brief Closes the open run of dest, e.g. once its buffer is flushed
+   */
+  void reset(int dest) { m_runs[dest].count = 0; }
+
+  size_t aggregated_count() const { return m_aggregated_count; }
+
+ private:
+  struct run {
+    lid_type   lid    = 0;
+    count_type count  = 0;
+    size_t     offset = 0;  // Start of the run (or its first message)
+    size_t     end    = 0;  // Buffer size after the last message of the run
+  };
+
+  std::vector<run> m_runs;
+  size_t           m_aggregated_count = 0;
+};
+
+}  // namespace detail
+}  // namespace ygm
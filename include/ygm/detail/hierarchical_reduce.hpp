@@ -0,0 +1,132 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <ygm/detail/mpi.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Non-blocking sum of a pair of counts, reduced within each node
+ * first and then across node leaders.
+ *
+ * The reduction runs as a chain of non-blocking collectives: an Ireduce to
+ * the node leader, an Iallreduce between leaders and an Ibcast back to the
+ * node.  Callers poll request() and call complete_stage() each time it
+ * completes, until complete_stage() returns true.
+ */
+class hierarchical_count_reducer {
+ public:
+  hierarchical_count_reducer(MPI_Comm comm) {
+    YGM_ASSERT_MPI(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0,
+                                       MPI_INFO_NULL, &m_comm_node));
+    int node_rank(0);
+    YGM_ASSERT_MPI(MPI_Comm_rank(m_comm_node, &node_rank));
+    m_leader = node_rank == 0;
+    YGM_ASSERT_MPI(MPI_Comm_split(comm, m_leader ? 0 : MPI_UNDEFINED, 0,
+                                  &m_comm_leaders));
+  }
+
+  ~hierarchical_count_reducer() {
+    YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm_node) == MPI_SUCCESS);
+    if (m_leader) {
+      YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm_leaders) == MPI_SUCCESS);
+    }
+  }
+
+  hierarchical_count_reducer(const hierarchical_count_reducer &) = delete;
+
+  /**
+   * @brief Posts the node-local stage of a new reduction
+   */
+  void start(uint64_t first, uint64_t second) {
+    YGM_ASSERT_RELEASE(m_stage == stage::idle);
+    m_local[0] = first;
+    m_local[1] = second;
+    m_stage    = stage::node_reduce;
+    YGM_ASSERT_MPI(MPI_Ireduce(m_local, m_node, 2, MPI_UINT64_T, MPI_SUM, 0,
+                               m_comm_node, &m_request));
+  }
+
+  /**
+   * @brief Request of the stage in flight
+   */
+  MPI_Request &request() { return m_request; }
+
+  /**
+   * @brief Advances past the stage whose request has completed
+   *
+   * @return True once global counts are available from result()
+   */
+  bool complete_stage() {
+    m_request = MPI_REQUEST_NULL;
+    switch (m_stage) {
+      case stage::node_reduce:
+        if (m_leader) {
+          m_stage = stage::leader_allreduce;
+          YGM_ASSERT_MPI(MPI_Iallreduce(m_node, m_global, 2, MPI_UINT64_T,
+                                        MPI_SUM, m_comm_leaders, &m_request));
+          return false;
+        }
+        [[fallthrough]];
+      case stage::leader_allreduce:
+        m_stage = stage::node_bcast;
+        YGM_ASSERT_MPI(MPI_Ibcast(m_global, 2, MPI_UINT64_T, 0, m_comm_node,
+                                  &m_request));
+        return false;
+      case stage::node_bcast:
+        m_stage = stage::idle;
+        return true;
+      case stage::idle:
+        break;
+    }
+    YGM_ASSERT_RELEASE(false);
+    return false;
+  }
+
+  /**
+   * @brief Tests the stage in flight, advancing through completed stages
+   *
+   * @return True once global counts are available from result()
+   */
+  bool test() {
+    while (true) {
+      int flag(0);
+      YGM_ASSERT_MPI(MPI_Test(&m_request, &flag, MPI_STATUS_IGNORE));
+      if (!flag) {
+        return false;
+      }
+      if (complete_stage()) {
+        return true;
+      }
+    }
+  }
+
+  bool in_progress() const { return m_stage != stage::idle; }
+
+  std::pair<uint64_t, uint64_t> result() const {
+    return {m_global[0], m_global[1]};
+  }
+
+ private:
+  enum class stage { idle, node_reduce, leader_allreduce, node_bcast };
+
+  MPI_Comm    m_comm_node;
+  MPI_Comm    m_comm_leaders = MPI_COMM_NULL;
+  bool        m_leader       = false;
+  stage       m_stage        = stage::idle;
+  MPI_Request m_request      = MPI_REQUEST_NULL;
+  uint64_t    m_local[2]     = {0, 0};
+  uint64_t    m_node[2]      = {0, 0};
+  uint64_t    m_global[2]    = {0, 0};
+};
+
+}  // namespace detail
+}  // namespace ygm
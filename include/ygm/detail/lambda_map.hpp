@@ -5,16 +5,39 @@
 
 #pragma once
 
+#include <cstdlib>
 #include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <vector>
 #include <ygm/detail/mpi.hpp>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
 
 namespace ygm {
 namespace detail {
 
+/**
+ * @brief Returns the demangled form of a typeid name when the ABI supports it
+ */
+inline std::string demangle(const char *name) {
+#if defined(__GNUG__)
+  int                                    status = 0;
+  std::unique_ptr<char, void (*)(void *)> demangled(
+      abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+  if (status == 0) {
+    return demangled.get();
+  }
+#endif
+  return name;
+}
+
 template <typename CFuncPtr, typename FuncId>
 class lambda_map {
-  template <typename LambdaType>
+  template <typename LambdaType, typename NameType>
   struct lambda_enumerator {
     const static FuncId id;
   };
@@ -22,33 +45,55 @@ class lambda_map {
  public:
   using func_id = FuncId;
 
-  template <typename LambdaType>
+  /**
+   * @brief Returns the id of a captureless lambda
+   *
+   * @tparam NameType Type whose name is recorded for the id, e.g. the user
+   * lambda wrapped by LambdaType
+   */
+  template <typename NameType = void, typename LambdaType>
   static FuncId register_lambda(LambdaType l) {
-    return lambda_enumerator<LambdaType>::id;
+    return lambda_enumerator<LambdaType, NameType>::id;
   }
   template <typename... Args>
   void execute(FuncId id, const Args... args) {
     s_map[id](args...);
   }
 
+  static size_t size() { return s_map.size(); }
+
+  /**
+   * @brief Demangled type name recorded when id was registered
+   */
+  static const std::string &name(FuncId id) { return s_names[id]; }
+
  private:
-  template <typename LambdaType>
+  template <typename LambdaType, typename NameType>
   static FuncId record() {
     YGM_ASSERT_RELEASE(s_map.size() < std::numeric_limits<FuncId>::max());
     FuncId      to_return = s_map.size();
     LambdaType *lp;  // scary, but by definition can't capture
     s_map.push_back(*lp);
+    if constexpr (std::is_void_v<NameType>) {
+      s_names.push_back(demangle(typeid(LambdaType).name()));
+    } else {
+      s_names.push_back(demangle(typeid(NameType).name()));
+    }
     return to_return;
   }
-  static std::vector<CFuncPtr> s_map;
+  static std::vector<CFuncPtr>    s_map;
+  static std::vector<std::string> s_names;
 };
 template <typename CFuncPtr, typename FuncId>
 std::vector<CFuncPtr> lambda_map<CFuncPtr, FuncId>::s_map;
+template <typename CFuncPtr, typename FuncId>
+std::vector<std::string> lambda_map<CFuncPtr, FuncId>::s_names;
 
 template <typename CFuncPtr, typename FuncId>
-template <typename LambdaType>
-const FuncId lambda_map<CFuncPtr, FuncId>::lambda_enumerator<LambdaType>::id =
-    lambda_map<CFuncPtr, FuncId>::record<LambdaType>();
+template <typename LambdaType, typename NameType>
+const FuncId
+    lambda_map<CFuncPtr, FuncId>::lambda_enumerator<LambdaType, NameType>::id =
+        lambda_map<CFuncPtr, FuncId>::record<LambdaType, NameType>();
 
 }  // namespace detail
 }  // namespace ygm
@@ -12,8 +12,15 @@
 namespace ygm::detail {
 class mpi_init_finalize {
  public:
-  mpi_init_finalize(int *argc, char ***argv) {
-    YGM_ASSERT_MPI(MPI_Init(argc, argv));
+  mpi_init_finalize(int *argc, char ***argv,
+                    int required_thread_level = MPI_THREAD_SINGLE) {
+    if (required_thread_level == MPI_THREAD_SINGLE) {
+      YGM_ASSERT_MPI(MPI_Init(argc, argv));
+    } else {
+      int provided(0);
+      YGM_ASSERT_MPI(
+          MPI_Init_thread(argc, argv, required_thread_level, &provided));
+    }
   }
   ~mpi_init_finalize() {
     YGM_ASSERT_RELEASE(MPI_Barrier(MPI_COMM_WORLD) == MPI_SUCCESS);
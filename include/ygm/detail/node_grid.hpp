@@ -0,0 +1,57 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Arranges nodes row-major in a virtual 2D grid with ceil(sqrt(nodes))
+ * columns, so that routing along a row and then a column reaches any node in
+ * at most two hops while each node only talks to O(sqrt(nodes)) others.
+ *
+ * The last row may be partial.  When the row-first intermediate node falls in
+ * its missing part, the route goes column-first instead, which stays within
+ * the grid.
+ */
+class node_grid {
+ public:
+  node_grid(int num_nodes) : m_num_nodes(num_nodes), m_cols(1) {
+    while (m_cols * m_cols < m_num_nodes) {
+      ++m_cols;
+    }
+  }
+
+  int cols() const { return m_cols; }
+
+  int rows() const { return (m_num_nodes + m_cols - 1) / m_cols; }
+
+  int row(int node) const { return node / m_cols; }
+
+  int col(int node) const { return node % m_cols; }
+
+  /**
+   * @brief Node to forward to from node on the way to dest_node
+   */
+  int next_node(int node, int dest_node) const {
+    if (row(node) == row(dest_node) || col(node) == col(dest_node)) {
+      return dest_node;
+    }
+    int row_first = row(node) * m_cols + col(dest_node);
+    if (row_first < m_num_nodes) {
+      return row_first;
+    }
+    return row(dest_node) * m_cols + col(node);
+  }
+
+ private:
+  int m_num_nodes;
+  int m_cols;
+};
+
+}  // namespace detail
+}  // namespace ygm
@@ -0,0 +1,74 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <vector>
+#include <ygm/detail/byte_vector.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Power-of-two size-class pool of receive buffers.
+ *
+ * Used by the probe-based receive path so each receive is sized to its
+ * message instead of a fixed, worst-case irecv size.
+ */
+class recv_buffer_pool {
+ public:
+  recv_buffer_pool(size_t max_cached_per_class = 8)
+      : m_max_cached_per_class(max_cached_per_class) {}
+
+  /**
+   * @brief Returns a buffer with capacity of at least size bytes
+   */
+  std::shared_ptr<byte_vector> acquire(size_t size) {
+    size_t size_class = class_of(size);
+    if (size_class < m_free.size() && !m_free[size_class].empty()) {
+      std::shared_ptr<byte_vector> to_return = m_free[size_class].back();
+      m_free[size_class].pop_back();
+      m_cached_bytes -= to_return->capacity();
+      return to_return;
+    }
+    return std::make_shared<byte_vector>(size_t(1) << size_class);
+  }
+
+  /**
+   * @brief Returns a buffer to its size class, or frees it if the class
+   * already holds enough buffers
+   */
+  void release(std::shared_ptr<byte_vector> buffer) {
+    size_t size_class = std::bit_width(buffer->capacity()) - 1;
+    if (m_free.size() <= size_class) {
+      m_free.resize(size_class + 1);
+    }
+    if (m_free[size_class].size() < m_max_cached_per_class) {
+      buffer->clear();
+      m_cached_bytes += buffer->capacity();
+      m_free[size_class].push_back(std::move(buffer));
+    }
+  }
+
+  size_t cached_bytes() const { return m_cached_bytes; }
+
+ private:
+  static size_t class_of(size_t size) {
+    return std::bit_width(std::max(size, min_size) - 1);
+  }
+
+  static constexpr size_t min_size = 4096;
+
+  size_t                                                 m_max_cached_per_class;
+  size_t                                                 m_cached_bytes = 0;
+  std::vector<std::vector<std::shared_ptr<byte_vector>>> m_free;
+};
+
+}  // namespace detail
+}  // namespace ygm
@@ -0,0 +1,249 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <ygm/detail/mpi.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Message transport over an MPI-3 RMA window of receive slots.
+ *
+ * Every rank exposes a notification counter, a state word per slot and the
+ * slots themselves.  A sender claims a free slot of the destination with
+ * MPI_Compare_and_swap, MPI_Puts the buffer into it, marks it full and bumps
+ * the counter with MPI_Fetch_and_op.  The receiver only scans its slots when
+ * the counter has moved, dispatches full slots in place and then frees them.
+ * No message goes through MPI tag matching.
+ *
+ * Slots carry a per-sender sequence number, so buffers from one sender are
+ * dispatched in the order they were pushed whatever slots they landed in.
+ * Every rank also counts the buffers it has consumed from each sender, which
+ * lets a sender tell when nothing of its is left in a destination's slots.
+ */
+class rma_transport {
+  enum slot_state : uint64_t { slot_free = 0, slot_full = 1, slot_claimed = 2 };
+
+  // Each slot starts with the buffer size, the sending rank and the sender's
+  // sequence number for this destination
+  static constexpr size_t header_size = 3 * sizeof(uint64_t);
+
+  // Slots tried before a sender gives up and falls back to MPI_Isend
+  static constexpr size_t max_claim_attempts = 2;
+
+ public:
+  rma_transport(MPI_Comm comm, size_t num_slots, size_t slot_size)
+      : m_num_slots(num_slots),
+        m_slot_stride(header_size + round_up(slot_size)),
+        m_states(num_slots, slot_free),
+        m_in_dispatch(num_slots, false) {
+    YGM_ASSERT_RELEASE(m_num_slots > 0);
+    YGM_ASSERT_MPI(MPI_Comm_dup(comm, &m_comm));
+    YGM_ASSERT_MPI(MPI_Comm_rank(m_comm, &m_rank));
+    YGM_ASSERT_MPI(MPI_Comm_size(m_comm, &m_size));
+    m_next_slot.resize(m_size, m_rank % m_num_slots);
+    m_push_seq.resize(m_size, 0);
+    m_next_seq.resize(m_size, 0);
+
+    YGM_ASSERT_MPI(MPI_Win_allocate(slot_disp(m_num_slots), 1, MPI_INFO_NULL,
+                                    m_comm, &m_base, &m_win));
+    std::fill((uint64_t *)m_base, (uint64_t *)(m_base + slot_disp(0)), 0);
+    YGM_ASSERT_MPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win));
+    YGM_ASSERT_MPI(MPI_Win_sync(m_win));
+    YGM_ASSERT_MPI(MPI_Barrier(m_comm));
+  }
+
+  ~rma_transport() {
+    YGM_ASSERT_RELEASE(MPI_Barrier(m_comm) == MPI_SUCCESS);
+    YGM_ASSERT_RELEASE(MPI_Win_unlock_all(m_win) == MPI_SUCCESS);
+    YGM_ASSERT_RELEASE(MPI_Win_free(&m_win) == MPI_SUCCESS);
+    YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm) == MPI_SUCCESS);
+  }
+
+  rma_transport(const rma_transport &) = delete;
+
+  /**
+   * @brief Writes a send buffer into a free slot of dest.
+   *
+   * @return False if the buffer is larger than a slot or no free slot was
+   * found, in which case nothing was written
+   */
+  bool try_push(int dest, const std::byte *data, size_t size) {
+    if (header_size + size > m_slot_stride) {
+      return false;
+    }
+    for (size_t attempt = 0; attempt < max_claim_attempts; ++attempt) {
+      size_t   slot    = m_next_slot[dest];
+      uint64_t free    = slot_free;
+      uint64_t claimed = slot_claimed;
+      uint64_t previous;
+      m_next_slot[dest] = (slot + 1) % m_num_slots;
+      YGM_ASSERT_MPI(MPI_Compare_and_swap(&claimed, &free, &previous,
+                                          MPI_UINT64_T, dest,
+                                          state_disp(slot), m_win));
+      YGM_ASSERT_MPI(MPI_Win_flush(dest, m_win));
+      if (previous != slot_free) {
+        continue;
+      }
+
+      uint64_t header[3] = {size, uint64_t(m_rank), m_push_seq[dest]++};
+      YGM_ASSERT_MPI(MPI_Put(header, header_size, MPI_BYTE, dest,
+                             slot_disp(slot), header_size, MPI_BYTE, m_win));
+      YGM_ASSERT_MPI(MPI_Put(data, size, MPI_BYTE, dest,
+                             slot_disp(slot) + header_size, size, MPI_BYTE,
+                             m_win));
+      // Puts are unordered with the atomics below, so complete them first
+      YGM_ASSERT_MPI(MPI_Win_flush(dest, m_win));
+      uint64_t full = slot_full;
+      YGM_ASSERT_MPI(MPI_Accumulate(&full, 1, MPI_UINT64_T, dest,
+                                    state_disp(slot), 1, MPI_UINT64_T,
+                                    MPI_REPLACE, m_win));
+      YGM_ASSERT_MPI(MPI_Win_flush(dest, m_win));
+      uint64_t one = 1;
+      uint64_t count;
+      YGM_ASSERT_MPI(MPI_Fetch_and_op(&one, &count, MPI_UINT64_T, dest, 0,
+                                      MPI_SUM, m_win));
+      YGM_ASSERT_MPI(MPI_Win_flush(dest, m_win));
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief True once dest has dispatched every buffer this rank pushed to it.
+   * Buffers sent by MPI after this cannot overtake one in a slot.
+   */
+  bool drained(int dest) const {
+    uint64_t consumed;
+    YGM_ASSERT_MPI(MPI_Fetch_and_op(nullptr, &consumed, MPI_UINT64_T, dest,
+                                    consumed_disp(m_rank), MPI_NO_OP, m_win));
+    YGM_ASSERT_MPI(MPI_Win_flush(dest, m_win));
+    return consumed == m_push_seq[dest];
+  }
+
+  /**
+   * @brief Dispatches every full slot of this rank, in sequence order per
+   * sender.
+   *
+   * @param fn Called as fn(source, data, size).  May recursively call poll();
+   * a slot is freed once its dispatch returns, and its live state is
+   * re-checked before dispatch so recursive polls never deliver it twice.
+   * @return True if any slots were dispatched
+   */
+  template <typename Function>
+  bool poll(Function fn) {
+    uint64_t count;
+    YGM_ASSERT_MPI(MPI_Fetch_and_op(nullptr, &count, MPI_UINT64_T, m_rank, 0,
+                                    MPI_NO_OP, m_win));
+    YGM_ASSERT_MPI(MPI_Win_flush(m_rank, m_win));
+    if (count == m_seen_count) {
+      return false;
+    }
+    m_seen_count = count;
+
+    YGM_ASSERT_MPI(MPI_Get_accumulate(
+        nullptr, 0, MPI_UINT64_T, m_states.data(), m_num_slots, MPI_UINT64_T,
+        m_rank, state_disp(0), m_num_slots, MPI_UINT64_T, MPI_NO_OP, m_win));
+    YGM_ASSERT_MPI(MPI_Win_flush(m_rank, m_win));
+    YGM_ASSERT_MPI(MPI_Win_sync(m_win));
+
+    // Sequence numbers only grow, so sorting puts each sender's slots in the
+    // order they were pushed.  Copied as recursive polls overwrite m_states.
+    std::vector<std::pair<uint64_t, size_t>> full_slots;
+    for (size_t slot = 0; slot < m_num_slots; ++slot) {
+      if (m_states[slot] == slot_full && !m_in_dispatch[slot]) {
+        full_slots.emplace_back(header(slot)[2], slot);
+      }
+    }
+    std::sort(full_slots.begin(), full_slots.end());
+
+    bool dispatched = false;
+    for (const auto &[seq, slot] : full_slots) {
+      // A recursive poll from an earlier dispatch may have consumed and freed
+      // this slot since the snapshot, and a sender may be rewriting it
+      if (m_in_dispatch[slot] || load_state(slot) != slot_full) {
+        continue;
+      }
+      uint64_t *h      = header(slot);
+      int       source = int(h[1]);
+      if (h[2] != m_next_seq[source]) {
+        // Refilled since the snapshot, a later poll picks it up in order
+        continue;
+      }
+      ++m_next_seq[source];
+      m_in_dispatch[slot] = true;
+      fn(source, (std::byte *)h + header_size, size_t(h[0]));
+      m_in_dispatch[slot] = false;
+
+      uint64_t free = slot_free;
+      YGM_ASSERT_MPI(MPI_Accumulate(&free, 1, MPI_UINT64_T, m_rank,
+                                    state_disp(slot), 1, MPI_UINT64_T,
+                                    MPI_REPLACE, m_win));
+      uint64_t one = 1;
+      YGM_ASSERT_MPI(MPI_Accumulate(&one, 1, MPI_UINT64_T, m_rank,
+                                    consumed_disp(source), 1, MPI_UINT64_T,
+                                    MPI_SUM, m_win));
+      YGM_ASSERT_MPI(MPI_Win_flush(m_rank, m_win));
+      dispatched = true;
+    }
+    return dispatched;
+  }
+
+ private:
+  uint64_t load_state(size_t slot) {
+    uint64_t state;
+    YGM_ASSERT_MPI(MPI_Fetch_and_op(nullptr, &state, MPI_UINT64_T, m_rank,
+                                    state_disp(slot), MPI_NO_OP, m_win));
+    YGM_ASSERT_MPI(MPI_Win_flush(m_rank, m_win));
+    YGM_ASSERT_MPI(MPI_Win_sync(m_win));
+    return state;
+  }
+
+  uint64_t *header(size_t slot) const {
+    return (uint64_t *)(m_base + slot_disp(slot));
+  }
+
+  // Window layout: [counter][state per slot][consumed per sender][slots]
+  MPI_Aint state_disp(size_t slot) const {
+    return sizeof(uint64_t) * (1 + slot);
+  }
+
+  MPI_Aint consumed_disp(int source) const {
+    return state_disp(m_num_slots) + sizeof(uint64_t) * source;
+  }
+
+  MPI_Aint slot_disp(size_t slot) const {
+    return consumed_disp(m_size) + slot * m_slot_stride;
+  }
+
+  static size_t round_up(size_t s) {
+    return (s + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+  }
+
+  size_t                m_num_slots;
+  size_t                m_slot_stride;
+  MPI_Comm              m_comm;
+  MPI_Win               m_win;
+  int                   m_rank;
+  int                   m_size;
+  std::byte            *m_base       = nullptr;
+  uint64_t              m_seen_count = 0;
+  std::vector<size_t>   m_next_slot;
+  std::vector<uint64_t> m_push_seq;
+  std::vector<uint64_t> m_next_seq;
+  std::vector<uint64_t> m_states;
+  std::vector<bool>     m_in_dispatch;
+};
+
+}  // namespace detail
+}  // namespace ygm
@@ -0,0 +1,145 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <ygm/detail/byte_vector.hpp>
+#include <ygm/detail/trivial_pack.hpp>
+#include <ygm/detail/ygm_cereal_archive.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Merges routed messages of one handler that a forwarding rank
+ * receives in the same buffer.
+ *
+ * Messages are merged when they go to the same destination and agree on the
+ * function object and every argument but the last, which is combined.
+ */
+class route_combiner {
+ public:
+  virtual ~route_combiner() = default;
+
+  /**
+   * @brief Reads a message bound for dest, positioned after its handler id
+   *
+   * @return True if it was merged into a message already pending
+   */
+  virtual bool absorb(int dest, cereal::YGMInputArchive &iarchive) = 0;
+
+  /**
+   * @brief Calls emit(dest, message) with every pending message, starting
+   * with its handler id, and forgets them
+   */
+  template <typename Emit>
+  void drain(const archive_options &options, Emit emit) {
+    byte_vector message;
+    for (size_t i = 0; i < pending_count(); ++i) {
+      message.clear();
+      int dest = pack_pending(i, message, options);
+      emit(dest, message);
+    }
+    clear();
+  }
+
+  virtual size_t pending_count() const = 0;
+
+ protected:
+  virtual int  pack_pending(size_t i, byte_vector &message,
+                            const archive_options &options) const = 0;
+  virtual void clear()                                              = 0;
+};
+
+template <typename Lambda, typename Combiner, typename... Args>
+class typed_route_combiner : public route_combiner {
+  static_assert(sizeof...(Args) > 0, "route combiners merge the last argument");
+
+  using args_type = std::tuple<Args...>;
+  static constexpr size_t value_index = sizeof...(Args) - 1;
+
+ public:
+  typed_route_combiner(uint16_t lid, Combiner combine)
+      : m_lid(lid), m_combine(combine) {}
+
+  bool absorb(int dest, cereal::YGMInputArchive &iarchive) override {
+    message m{dest};
+    if constexpr (!std::is_empty_v<Lambda>) {
+      iarchive.loadBinary(m.lambda_storage, sizeof(Lambda));
+    }
+    unpack_arguments(iarchive, m.args);
+
+    // Serialized destination, function object and leading arguments
+    m_key.clear();
+    m_key.push_bytes(&dest, sizeof(dest));
+    if constexpr (!std::is_empty_v<Lambda>) {
+      m_key.push_bytes(m.lambda_storage, sizeof(Lambda));
+    }
+    pack_key(m.args, std::make_index_sequence<value_index>());
+    std::string key((const char *)m_key.data(), m_key.size());
+
+    auto itr = m_index.find(key);
+    if (itr == m_index.end()) {
+      m_index.emplace(std::move(key), m_pending.size());
+      m_pending.push_back(std::move(m));
+      return false;
+    }
+    auto &value = std::get<value_index>(m_pending[itr->second].args);
+    value       = m_combine(value, std::get<value_index>(m.args));
+    return true;
+  }
+
+  size_t pending_count() const override { return m_pending.size(); }
+
+ protected:
+  int pack_pending(size_t i, byte_vector &packed,
+                   const archive_options &options) const override {
+    const message &m = m_pending[i];
+    packed.push_bytes(&m_lid, sizeof(m_lid));
+    if constexpr (!std::is_empty_v<Lambda>) {
+      packed.push_bytes(m.lambda_storage, sizeof(Lambda));
+    }
+    std::apply(
+        [&packed, &options](const Args &...args) {
+          pack_arguments(packed, options, args...);
+        },
+        m.args);
+    return m.dest;
+  }
+
+  void clear() override {
+    m_pending.clear();
+    m_index.clear();
+  }
+
+ private:
+  struct message {
+    int dest;
+    // Function object bytes, only read back by the handler
+    std::byte lambda_storage[std::is_empty_v<Lambda> ? 1 : sizeof(Lambda)];
+    args_type args;
+  };
+
+  template <size_t... I>
+  void pack_key(const args_type &args, std::index_sequence<I...>) {
+    pack_arguments(m_key, {}, std::get<I>(args)...);
+  }
+
+  uint16_t                                m_lid;
+  Combiner                                m_combine;
+  std::vector<message>                    m_pending;
+  std::unordered_map<std::string, size_t> m_index;
+  byte_vector                             m_key;
+};
+
+}  // namespace detail
+}  // namespace ygm
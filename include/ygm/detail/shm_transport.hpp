@@ -0,0 +1,195 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+#include <ygm/detail/layout.hpp>
+#include <ygm/detail/mpi.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief On-node message transport over an MPI-3 shared memory window.
+ *
+ * Every rank owns one single-producer/single-consumer ring per local sender.
+ * Senders copy whole send buffers directly into the receiver's ring, and the
+ * receiver dispatches records in place before releasing the ring space.
+ * Records from one sender are dispatched in the order they were pushed.
+ */
+class shm_transport {
+  struct ring_header {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+  };
+
+  static constexpr uint64_t wrap_marker = std::numeric_limits<uint64_t>::max();
+
+ public:
+  shm_transport(MPI_Comm comm, const layout &l, size_t ring_size)
+      : m_layout(l),
+        m_ring_size((ring_size + sizeof(ring_header) - 1) /
+                    sizeof(ring_header) * sizeof(ring_header)) {
+    YGM_ASSERT_MPI(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED,
+                                       m_layout.rank(), MPI_INFO_NULL,
+                                       &m_comm_local));
+    int local_size(0);
+    YGM_ASSERT_MPI(MPI_Comm_size(m_comm_local, &local_size));
+    YGM_ASSERT_RELEASE(local_size == m_layout.local_size());
+
+    std::byte *my_base = nullptr;
+    YGM_ASSERT_MPI(MPI_Win_allocate_shared(
+        local_size * ring_stride(), 1, MPI_INFO_NULL, m_comm_local, &my_base,
+        &m_win));
+    YGM_ASSERT_MPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win));
+
+    // Initialize the rings this rank consumes from
+    for (int i = 0; i < local_size; ++i) {
+      ring_header *r = new (my_base + i * ring_stride()) ring_header;
+      r->head.store(0);
+      r->tail.store(0);
+    }
+
+    m_segments.resize(local_size);
+    for (int i = 0; i < local_size; ++i) {
+      MPI_Aint   seg_size;
+      int        disp_unit;
+      std::byte *base = nullptr;
+      YGM_ASSERT_MPI(
+          MPI_Win_shared_query(m_win, i, &seg_size, &disp_unit, &base));
+      m_segments[i] = base;
+    }
+    m_read_pos.resize(local_size, 0);
+    m_dispatch_depth.resize(local_size, 0);
+
+    YGM_ASSERT_MPI(MPI_Win_sync(m_win));
+    YGM_ASSERT_MPI(MPI_Barrier(m_comm_local));
+  }
+
+  ~shm_transport() {
+    YGM_ASSERT_RELEASE(MPI_Barrier(m_comm_local) == MPI_SUCCESS);
+    YGM_ASSERT_RELEASE(MPI_Win_unlock_all(m_win) == MPI_SUCCESS);
+    YGM_ASSERT_RELEASE(MPI_Win_free(&m_win) == MPI_SUCCESS);
+    YGM_ASSERT_RELEASE(MPI_Comm_free(&m_comm_local) == MPI_SUCCESS);
+  }
+
+  shm_transport(const shm_transport &) = delete;
+
+  /**
+   * @brief Copies a send buffer into the ring of a local destination.
+   *
+   * @param dest World rank of an on-node destination
+   * @return False if the ring does not currently have room for the buffer
+   */
+  bool try_push(int dest, const std::byte *data, size_t size) {
+    uint64_t record_size = sizeof(uint64_t) + round_up(size);
+    if (record_size > m_ring_size) {
+      return false;
+    }
+    ring_header *r    = ring(m_layout.local_id(dest), m_layout.local_id());
+    std::byte   *ring_data = reinterpret_cast<std::byte *>(r + 1);
+    uint64_t     tail = r->tail.load(std::memory_order_relaxed);
+    uint64_t     head = r->head.load(std::memory_order_acquire);
+
+    uint64_t offset = tail % m_ring_size;
+    uint64_t to_end = m_ring_size - offset;
+    uint64_t needed = record_size + (to_end < record_size ? to_end : 0);
+    if (m_ring_size - (tail - head) < needed) {
+      return false;
+    }
+
+    // Records never wrap so they can be dispatched in place
+    if (to_end < record_size) {
+      std::memcpy(ring_data + offset, &wrap_marker, sizeof(uint64_t));
+      tail += to_end;
+      offset = 0;
+    }
+    uint64_t size64 = size;
+    std::memcpy(ring_data + offset, &size64, sizeof(uint64_t));
+    std::memcpy(ring_data + offset + sizeof(uint64_t), data, size);
+    r->tail.store(tail + record_size, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief True once dest has dispatched every record this rank pushed to it.
+   * Buffers sent by MPI after this cannot overtake a ring record.
+   */
+  bool drained(int dest) const {
+    ring_header *r = ring(m_layout.local_id(dest), m_layout.local_id());
+    return r->head.load(std::memory_order_acquire) ==
+           r->tail.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Dispatches every record available in this rank's rings.
+   *
+   * @param fn Called as fn(source_rank, data, size).  May recursively call
+   * poll(); ring space is released only once the outermost dispatch returns.
+   * @return True if any records were dispatched
+   */
+  template <typename Function>
+  bool poll(Function fn) {
+    bool dispatched = false;
+    for (int i = 0; i < m_layout.local_size(); ++i) {
+      ring_header *r         = ring(m_layout.local_id(), i);
+      std::byte   *ring_data = reinterpret_cast<std::byte *>(r + 1);
+      while (m_read_pos[i] != r->tail.load(std::memory_order_acquire)) {
+        uint64_t offset = m_read_pos[i] % m_ring_size;
+        uint64_t size;
+        std::memcpy(&size, ring_data + offset, sizeof(uint64_t));
+        if (size == wrap_marker) {
+          m_read_pos[i] += m_ring_size - offset;
+          release(r, i);
+          continue;
+        }
+        m_read_pos[i] += sizeof(uint64_t) + round_up(size);
+        ++m_dispatch_depth[i];
+        fn(m_layout.local_ranks()[i], ring_data + offset + sizeof(uint64_t),
+           size_t(size));
+        --m_dispatch_depth[i];
+        release(r, i);
+        dispatched = true;
+      }
+    }
+    return dispatched;
+  }
+
+ private:
+  void release(ring_header *r, int i) {
+    if (m_dispatch_depth[i] == 0) {
+      r->head.store(m_read_pos[i], std::memory_order_release);
+    }
+  }
+
+  ring_header *ring(int receiver_local_id, int sender_local_id) const {
+    return reinterpret_cast<ring_header *>(m_segments[receiver_local_id] +
+                                           sender_local_id * ring_stride());
+  }
+
+  size_t ring_stride() const { return sizeof(ring_header) + m_ring_size; }
+
+  static uint64_t round_up(uint64_t s) {
+    return (s + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+  }
+
+  const layout           &m_layout;
+  uint64_t                m_ring_size;
+  MPI_Comm                m_comm_local;
+  MPI_Win                 m_win;
+  std::vector<std::byte *> m_segments;
+  std::vector<uint64_t>   m_read_pos;
+  std::vector<size_t>     m_dispatch_depth;
+};
+
+}  // namespace detail
+}  // namespace ygm
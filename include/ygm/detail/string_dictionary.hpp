@@ -0,0 +1,96 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <ygm/detail/assert.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+/**
+ * @brief Strings already written to one send buffer, so that repeats are sent
+ * as an index into the table.
+ *
+ * The sender marks each string it adds to the table, and the receiver adds
+ * exactly the marked strings while decoding the buffer in order, so the two
+ * tables stay identical without ever being sent.
+ */
+class string_dictionary {
+ public:
+  static constexpr size_t npos        = std::numeric_limits<size_t>::max();
+  static constexpr size_t max_entries = size_t(1) << 16;
+  static constexpr size_t min_length  = 4;
+
+  /**
+   * @brief Looks up a string being sent, adding it to the table if it is new
+   *
+   * @param recorded Set when s was added and the receiver must record it
+   * @return Index of s if it was already sent, otherwise npos
+   */
+  size_t encode(std::string_view s, bool &recorded) {
+    recorded = false;
+    if (s.size() < min_length) {
+      return npos;
+    }
+    auto itr = m_index.find(s);
+    if (itr != m_index.end()) {
+      return itr->second;
+    }
+    if (m_index.size() < max_entries) {
+      m_index.emplace(s, m_index.size());
+      recorded = true;
+    }
+    return npos;
+  }
+
+  /**
+   * @brief Adds a string the sender marked as recorded
+   */
+  void record(std::string_view s) { m_strings.emplace_back(s); }
+
+  const std::string &lookup(size_t index) const {
+    YGM_ASSERT_RELEASE(index < m_strings.size());
+    return m_strings[index];
+  }
+
+  void clear() {
+    m_index.clear();
+    m_strings.clear();
+  }
+
+ private:
+  // Finds std::string_view without building a std::string
+  struct view_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const noexcept {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+  std::unordered_map<std::string, size_t, view_hash, std::equal_to<>> m_index;
+  // A deque, so string_views of looked up strings survive later records
+  std::deque<std::string> m_strings;
+};
+
+/**
+ * @brief Encoding selected for a YGM archive
+ */
+struct archive_options {
+  /// Integers and sizes are written as LEB128 varints
+  bool compact = false;
+  /// Repeated strings are written as indices into this table (compact only)
+  string_dictionary *dictionary = nullptr;
+};
+
+}  // namespace detail
+}  // namespace ygm
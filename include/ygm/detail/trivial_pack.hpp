@@ -0,0 +1,111 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <ygm/detail/byte_vector.hpp>
+#include <ygm/detail/ygm_cereal_archive.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+namespace ygm {
+
+namespace detail {
+
+template <typename T>
+struct is_ygm_ptr : std::false_type {};
+
+template <typename T>
+struct is_ygm_ptr<ygm_ptr<T>> : std::true_type {};
+
+/**
+ * @brief True when T has a cereal serialize, save or load, as a member or a
+ * free function, for the YGM archives
+ */
+template <typename T>
+inline constexpr bool has_cereal_serializer_v =
+    cereal::traits::detail::count_output_serializers<
+        T, cereal::YGMOutputArchive>::value > 0 ||
+    cereal::traits::detail::count_input_serializers<
+        T, cereal::YGMInputArchive>::value > 0;
+
+/**
+ * @brief True when an argument can be copied into a message byte for byte:
+ * arithmetic types, enums, ygm_ptr and trivially copyable classes without
+ * their own cereal serialization.  Everything else, e.g. raw pointers or
+ * std::string_view, still goes through cereal.
+ */
+template <typename T>
+inline constexpr bool is_trivially_packable_arg_v =
+    std::is_arithmetic_v<T> || std::is_enum_v<T> || is_ygm_ptr<T>::value ||
+    (std::is_class_v<T> && std::is_trivially_copyable_v<T> &&
+     !has_cereal_serializer_v<T>);
+
+/**
+ * @brief True when every argument can be packed byte for byte, bypassing
+ * cereal
+ */
+template <typename... Args>
+inline constexpr bool is_trivially_packable_v =
+    (is_trivially_packable_arg_v<Args> && ...);
+
+/**
+ * @brief Appends async arguments to a message, with memcpy when they are all
+ * trivially packable and with cereal otherwise.  Compact archives still write
+ * arithmetic arguments through the archive so that integers become varints.
+ */
+template <typename... Args>
+inline void pack_arguments(byte_vector &packed, const archive_options &options,
+                           const Args &...args) {
+  if constexpr (std::is_empty_v<std::tuple<Args...>>) {
+    return;
+  } else if constexpr (is_trivially_packable_v<Args...>) {
+    if (!options.compact) {
+      (packed.push_bytes(&args, sizeof(Args)), ...);
+      return;
+    }
+    cereal::YGMOutputArchive oarchive(packed, options);
+    auto                     save = [&oarchive](const auto &arg) {
+      if constexpr (std::is_arithmetic_v<std::decay_t<decltype(arg)>>) {
+        oarchive(arg);
+      } else {
+        oarchive.saveBinary(&arg, sizeof(arg));
+      }
+    };
+    (save(args), ...);
+  } else {
+    const std::tuple<Args...> tuple_args(args...);
+    cereal::YGMOutputArchive  oarchive(packed, options);
+    oarchive(tuple_args);
+  }
+}
+
+/**
+ * @brief Reads arguments written by pack_arguments()
+ */
+template <typename... Args>
+inline void unpack_arguments(cereal::YGMInputArchive &iarchive,
+                             std::tuple<Args...>     &tuple_args) {
+  if constexpr (std::is_empty_v<std::tuple<Args...>>) {
+    return;
+  } else if constexpr (is_trivially_packable_v<Args...>) {
+    auto load = [&iarchive](auto &arg) {
+      if constexpr (std::is_arithmetic_v<std::decay_t<decltype(arg)>>) {
+        if (iarchive.compact()) {
+          iarchive(arg);
+          return;
+        }
+      }
+      iarchive.loadBinary(&arg, sizeof(arg));
+    };
+    std::apply([&load](Args &...args) { (load(args), ...); }, tuple_args);
+  } else {
+    iarchive(tuple_args);
+  }
+}
+
+}  // namespace detail
+}  // namespace ygm
@@ -14,9 +14,13 @@
 #include <cereal/types/vector.hpp>
 #include <cereal/types/optional.hpp>
 #include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <ygm/detail/assert.hpp>
 #include <ygm/detail/byte_vector.hpp>
+#include <ygm/detail/string_dictionary.hpp>
 
 namespace cereal {
 // ######################################################################
@@ -43,9 +47,11 @@ class YGMOutputArchive
       : OutputArchive<YGMOutputArchive, AllowEmptyClassElision>(this),
         vec_data(stream) {}*/
 
-  YGMOutputArchive(ygm::detail::byte_vector &stream)
+  YGMOutputArchive(ygm::detail::byte_vector            &stream,
+                   const ygm::detail::archive_options &options = {})
       : OutputArchive<YGMOutputArchive, AllowEmptyClassElision>(this),
-        vec_data(stream) {}
+        vec_data(stream),
+        m_options(options) {}
 
   ~YGMOutputArchive() CEREAL_NOEXCEPT = default;
 
@@ -59,8 +65,27 @@ class YGMOutputArchive
     //                   std::to_string(writtenSize));
   }
 
+  //! Writes an unsigned LEB128 varint
+  void saveVarint(uint64_t value) {
+    uint8_t bytes[10];
+    size_t  count = 0;
+    while (value >= 0x80) {
+      bytes[count++] = uint8_t(value) | 0x80;
+      value >>= 7;
+    }
+    bytes[count++] = uint8_t(value);
+    vec_data.push_bytes(bytes, count);
+  }
+
+  bool compact() const { return m_options.compact; }
+
+  ygm::detail::string_dictionary *dictionary() const {
+    return m_options.dictionary;
+  }
+
  private:
-  ygm::detail::byte_vector &vec_data;
+  ygm::detail::byte_vector     &vec_data;
+  ygm::detail::archive_options m_options;
 };
 
 // ######################################################################
@@ -78,10 +103,12 @@ class YGMInputArchive
     : public InputArchive<YGMInputArchive, AllowEmptyClassElision> {
  public:
   //! Construct, loading from the provided stream
-  YGMInputArchive(std::byte *data, size_t capacity)
+  YGMInputArchive(std::byte *data, size_t capacity,
+                  const ygm::detail::archive_options &options = {})
       : InputArchive<YGMInputArchive, AllowEmptyClassElision>(this),
         m_pdata(data),
-        m_capacity(capacity) {}
+        m_capacity(capacity),
+        m_options(options) {}
 
   ~YGMInputArchive() CEREAL_NOEXCEPT = default;
 
@@ -97,24 +124,67 @@ class YGMInputArchive
     //                   std::to_string(readSize));
   }
 
+  //! Returns the next size bytes in place and skips past them
+  std::string_view loadView(size_t size) {
+    YGM_ASSERT_DEBUG(m_position + size <= m_capacity);
+    std::string_view to_return((const char *)(m_pdata + m_position), size);
+    m_position += size;
+    return to_return;
+  }
+
+  //! Reads an unsigned LEB128 varint
+  uint64_t loadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+      YGM_ASSERT_DEBUG(m_position < m_capacity && shift < 64);
+      uint8_t byte = uint8_t(m_pdata[m_position++]);
+      value |= uint64_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+  }
+
+  //! Bytes read so far
+  size_t position() const { return m_position; }
+
+  bool compact() const { return m_options.compact; }
+
+  ygm::detail::string_dictionary *dictionary() const {
+    return m_options.dictionary;
+  }
+
   bool empty() const {
     YGM_ASSERT_DEBUG(!(m_position > m_capacity));
     return m_position == m_capacity;
   }
 
  private:
-  std::byte *m_pdata;
-  size_t     m_position = 0;
-  size_t     m_capacity = 0;
+  std::byte                   *m_pdata;
+  size_t                       m_position = 0;
+  size_t                       m_capacity = 0;
+  ygm::detail::archive_options m_options;
 };
 
 // ######################################################################
 // Common BinaryArchive serialization functions
 
-//! Saving for POD types to binary
+//! Saving for POD types to binary, as varints in compact archives
 template <class T>
 inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
 CEREAL_SAVE_FUNCTION_NAME(YGMOutputArchive &ar, T const &t) {
+  if constexpr (std::is_integral<T>::value && sizeof(T) > 1) {
+    if (ar.compact()) {
+      if constexpr (std::is_signed<T>::value) {
+        // Zigzag so that small negative values stay short
+        int64_t v = t;
+        ar.saveVarint((uint64_t(v) << 1) ^ uint64_t(v >> 63));
+      } else {
+        ar.saveVarint(t);
+      }
+      return;
+    }
+  }
   ar.saveBinary(std::addressof(t), sizeof(t));
 }
 
@@ -122,9 +192,94 @@ CEREAL_SAVE_FUNCTION_NAME(YGMOutputArchive &ar, T const &t) {
 template <class T>
 inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
 CEREAL_LOAD_FUNCTION_NAME(YGMInputArchive &ar, T &t) {
+  if constexpr (std::is_integral<T>::value && sizeof(T) > 1) {
+    if (ar.compact()) {
+      uint64_t v = ar.loadVarint();
+      if constexpr (std::is_signed<T>::value) {
+        t = T(int64_t(v >> 1) ^ -int64_t(v & 1));
+      } else {
+        t = T(v);
+      }
+      return;
+    }
+  }
   ar.loadBinary(std::addressof(t), sizeof(t));
 }
 
+//! Saving strings.  Compact archives prefix a varint tag holding either a
+//! dictionary index (low bit set) or the length, shifted past a flag telling
+//! the receiver to record the string in its dictionary.  std::string_view is
+//! written the same way, so either type can be read back as the other.
+inline void CEREAL_SAVE_FUNCTION_NAME(YGMOutputArchive       &ar,
+                                      std::string_view const &str) {
+  if (!ar.compact()) {
+    ar(make_size_tag(static_cast<size_type>(str.size())));
+    ar.saveBinary(str.data(), str.size());
+    return;
+  }
+  bool recorded = false;
+  if (ygm::detail::string_dictionary *dict = ar.dictionary()) {
+    size_t index = dict->encode(str, recorded);
+    if (index != ygm::detail::string_dictionary::npos) {
+      ar.saveVarint((uint64_t(index) << 1) | 1);
+      return;
+    }
+  }
+  ar.saveVarint((uint64_t(str.size()) << 2) | (uint64_t(recorded) << 1));
+  ar.saveBinary(str.data(), str.size());
+}
+
+inline void CEREAL_SAVE_FUNCTION_NAME(YGMOutputArchive  &ar,
+                                      std::string const &str) {
+  CEREAL_SAVE_FUNCTION_NAME(ar, std::string_view(str));
+}
+
+//! Loading strings saved by the function above
+inline void CEREAL_LOAD_FUNCTION_NAME(YGMInputArchive &ar, std::string &str) {
+  if (!ar.compact()) {
+    size_type size;
+    ar(make_size_tag(size));
+    str.resize(static_cast<std::size_t>(size));
+    ar.loadBinary(str.data(), str.size());
+    return;
+  }
+  uint64_t tag = ar.loadVarint();
+  if (tag & 1) {
+    YGM_ASSERT_RELEASE(ar.dictionary() != nullptr);
+    str = ar.dictionary()->lookup(tag >> 1);
+    return;
+  }
+  str.resize(tag >> 2);
+  ar.loadBinary(str.data(), str.size());
+  if (tag & 2) {
+    YGM_ASSERT_RELEASE(ar.dictionary() != nullptr);
+    ar.dictionary()->record(str);
+  }
+}
+
+//! Loading a std::string_view that points into the archive's buffer, or into
+//! its dictionary, so it is only valid while the buffer is being dispatched
+inline void CEREAL_LOAD_FUNCTION_NAME(YGMInputArchive  &ar,
+                                      std::string_view &str) {
+  if (!ar.compact()) {
+    size_type size;
+    ar(make_size_tag(size));
+    str = ar.loadView(static_cast<std::size_t>(size));
+    return;
+  }
+  uint64_t tag = ar.loadVarint();
+  if (tag & 1) {
+    YGM_ASSERT_RELEASE(ar.dictionary() != nullptr);
+    str = ar.dictionary()->lookup(tag >> 1);
+    return;
+  }
+  str = ar.loadView(tag >> 2);
+  if (tag & 2) {
+    YGM_ASSERT_RELEASE(ar.dictionary() != nullptr);
+    ar.dictionary()->record(str);
+  }
+}
+
 //! Serializing NVP types to binary
 template <class Archive, class T>
 inline CEREAL_ARCHIVE_RESTRICT(YGMInputArchive, YGMOutputArchive)
@@ -36,7 +36,8 @@ class ygm_ptr {
     sptrs.push_back(t);
   }
 
-  ygm_ptr(const ygm::ygm_ptr<T> &t) { idx = t.idx; }
+  // Defaulted so async arguments holding a ygm_ptr stay trivially copyable
+  ygm_ptr(const ygm::ygm_ptr<T> &t) = default;
 
   T *get_raw_pointer() { return operator->(); }
 
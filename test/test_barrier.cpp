@@ -5,6 +5,7 @@
 
 #undef NDEBUG
 
+#include <sstream>
 #include <ygm/comm.hpp>
 
 int main(int argc, char **argv) {
@@ -24,5 +25,35 @@ int main(int argc, char **argv) {
     }
   }
 
+  // Test barriers with no traffic since the previous barrier take one round
+  {
+    world.barrier();
+    world.stats_reset();
+    world.barrier();
+    std::stringstream ss;
+    world.stats_print("idle", ss);
+    if (world.rank0()) {
+      YGM_ASSERT_RELEASE(ss.str().find("COUNT_IALLREDUCE         = 1\n") !=
+                         std::string::npos);
+    }
+  }
+
+  // Test message chains spanning several rounds still complete
+  {
+    static int hops = 0;
+    struct hop {
+      void operator()(ygm::comm *pcomm, int remaining) const {
+        ++hops;
+        if (remaining > 0) {
+          pcomm->async((pcomm->rank() + 1) % pcomm->size(), hop(),
+                       remaining - 1);
+        }
+      }
+    };
+    world.async((world.rank() + 1) % world.size(), hop(), 50);
+    world.barrier();
+    YGM_ASSERT_RELEASE(world.all_reduce_sum(hops) == 51 * world.size());
+  }
+
   return 0;
 }
@@ -72,5 +72,51 @@ int main() {
     YGM_ASSERT_RELEASE(test_it1 < ++test_it2);
   }
 
+  {
+    // pooled allocation reuses released blocks
+    auto &pool = ygm::detail::byte_vector_pool::instance();
+    pool.configure(true, 64 * 1024 * 1024,
+                   ygm::detail::byte_vector_pool::huge_page_type::THP);
+    pool.reset_stats();
+    size_t page = getpagesize();
+    {
+      ygm::detail::byte_vector bv(3 * page);
+      YGM_ASSERT_RELEASE(bv.capacity() == 4 * page);
+    }
+    YGM_ASSERT_RELEASE(pool.cached_bytes() == 4 * page);
+    {
+      ygm::detail::byte_vector bv(4 * page);
+      YGM_ASSERT_RELEASE(pool.hits() == 1);
+      YGM_ASSERT_RELEASE(pool.cached_bytes() == 0);
+    }
+
+    // growth keeps contents, including into huge page sized blocks
+    ygm::detail::byte_vector grown;
+    for (uint32_t i = 0; i < 1024 * 1024; ++i) {
+      grown.push_bytes(&i, sizeof(i));
+    }
+    YGM_ASSERT_RELEASE(grown.capacity() == 4 * 1024 * 1024);
+    for (uint32_t i = 0; i < 1024 * 1024; ++i) {
+      uint32_t v;
+      memcpy(&v, grown.data() + i * sizeof(i), sizeof(v));
+      YGM_ASSERT_RELEASE(v == i);
+    }
+
+    // reserving less than the capacity keeps the block and its contents
+    grown.reserve(page);
+    YGM_ASSERT_RELEASE(grown.capacity() == 4 * 1024 * 1024);
+    YGM_ASSERT_RELEASE(grown.size() == 4 * 1024 * 1024);
+    uint32_t last;
+    memcpy(&last, grown.data() + grown.size() - sizeof(last), sizeof(last));
+    YGM_ASSERT_RELEASE(last == 1024 * 1024 - 1);
+
+    pool.trim();
+    YGM_ASSERT_RELEASE(pool.cached_bytes() == 0);
+    pool.configure(false, 0,
+                   ygm::detail::byte_vector_pool::huge_page_type::NONE);
+    ygm::detail::byte_vector unpooled(3 * page);
+    YGM_ASSERT_RELEASE(unpooled.capacity() == 3 * page);
+  }
+
   return 0;
 }
\ No newline at end of file
@@ -37,5 +37,43 @@ int main() {
     YGM_ASSERT_RELEASE(vec_sentences == out_sentences);
   }
 
+  //
+  // Test std::string_view is read in place and interchangeable with
+  // std::string, in plain and compact archives with a dictionary
+  for (bool compact : {false, true}) {
+    ygm::detail::string_dictionary send_dictionary;
+    ygm::detail::string_dictionary recv_dictionary;
+    ygm::detail::byte_vector       views;
+    {
+      cereal::YGMOutputArchive archive(
+          views, {compact, compact ? &send_dictionary : nullptr});
+      for (const auto& s : vec_sentences) {
+        archive(std::string_view(s), s);
+      }
+    }
+
+    cereal::YGMInputArchive archive(
+        views.data(), views.size(),
+        {compact, compact ? &recv_dictionary : nullptr});
+    std::vector<std::string_view> out_views;
+    while (!archive.empty()) {
+      std::string      s;
+      std::string_view v;
+      archive(s, v);
+      YGM_ASSERT_RELEASE(s == v);
+      out_views.push_back(v);
+    }
+    YGM_ASSERT_RELEASE(out_views.size() == vec_sentences.size());
+    for (size_t i = 0; i < out_views.size(); ++i) {
+      YGM_ASSERT_RELEASE(out_views[i] == vec_sentences[i]);
+    }
+    if (!compact) {
+      // Points into the buffer rather than a copy
+      YGM_ASSERT_RELEASE((const std::byte*)out_views[0].data() > views.data());
+      YGM_ASSERT_RELEASE((const std::byte*)out_views[0].data() <
+                         views.data() + views.size());
+    }
+  }
+
   return 0;
 }
@@ -10,7 +10,7 @@
 int main(int argc, char** argv) {
   YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
 
-  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR", "GRID"};
   for (const auto& routing_scheme : routing_schemes) {
     setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
 
@@ -0,0 +1,118 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <sstream>
+#include <ygm/comm.hpp>
+#include <ygm/detail/adaptive_buffer_policy.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_ADAPTIVE_BUFFERS", "1", 1);
+  setenv("YGM_COM_BUFFER_SIZE_KB", "64", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test skewed traffic, most messages go to rank 0
+    {
+      size_t counter{};
+      size_t num_messages = 50000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        int dest = (i % 8 == 0) ? int(i / 8) % world.size() : 0;
+        world.async(
+            dest,
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "skewed");
+              (*pcounter)++;
+            },
+            pcounter, std::string("skewed"));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test async_bcast
+    {
+      size_t counter{};
+      int    num_bcasts = 100;
+      auto   pcounter   = world.make_ygm_ptr(counter);
+      for (int i = 0; i < num_bcasts; ++i) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == num_bcasts * world.size());
+    }
+
+    //
+    // Test thresholds follow traffic within the budget
+    {
+      const auto&                         l      = world.layout();
+      size_t                              budget = 1024 * 1024;
+      ygm::detail::adaptive_buffer_policy policy(l, budget, budget);
+
+      int              hot = 0;
+      std::vector<int> group;
+      for (int dest = 0; dest < world.size(); ++dest) {
+        if (l.is_local(dest) == l.is_local(hot)) {
+          group.push_back(dest);
+        }
+      }
+      std::vector<size_t> initial(world.size());
+      for (int dest = 0; dest < world.size(); ++dest) {
+        initial[dest] = policy.reserve_size(dest);
+      }
+
+      for (size_t epoch = 0; epoch < 8; ++epoch) {
+        while (policy.rebalance_count() == epoch) {
+          policy.record_flush(hot, 64 * 1024);
+        }
+      }
+      YGM_ASSERT_RELEASE(policy.rebalance_count() >= 8);
+
+      size_t local_sum(0), remote_sum(0);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        YGM_ASSERT_RELEASE(policy.flush_threshold(dest) ==
+                           policy.reserve_size(dest));
+        (l.is_local(dest) ? local_sum : remote_sum) +=
+            policy.reserve_size(dest);
+      }
+      YGM_ASSERT_RELEASE(local_sum <= budget);
+      YGM_ASSERT_RELEASE(remote_sum <= budget);
+
+      // A hot destination is capped at half the budget, so growth is only
+      // observable when its uniform share started below that
+      if (group.size() > 1 && initial[hot] < budget / 2) {
+        YGM_ASSERT_RELEASE(policy.reserve_size(hot) > initial[hot]);
+        int cold = group.back();
+        YGM_ASSERT_RELEASE(policy.reserve_size(cold) < initial[cold]);
+      }
+    }
+
+    //
+    // Test stats report the adaptive policy
+    {
+      std::stringstream ss;
+      world.stats_print("adaptive", ss);
+      if (world.rank0()) {
+        YGM_ASSERT_RELEASE(ss.str().find("MAX_ADAPTIVE_REBALANCES") !=
+                           std::string::npos);
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <sstream>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_AGGREGATE_HANDLERS", "1", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test long runs of a single handler
+    {
+      size_t counter{};
+      size_t num_messages = 100000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, size_t i, size_t num_messages) {
+              YGM_ASSERT_RELEASE(i < num_messages);
+              (*pcounter)++;
+            },
+            pcounter, i, num_messages);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test interleaved handlers with variable sized arguments keep order
+    {
+      std::vector<std::string> received;
+      size_t                   empty_count{};
+      auto                     preceived    = world.make_ygm_ptr(received);
+      auto                     pempty_count = world.make_ygm_ptr(empty_count);
+      size_t                   num_messages = 10000;
+      for (size_t i = 0; i < num_messages; ++i) {
+        int dest = (world.rank() + 1) % world.size();
+        world.async(
+            dest,
+            [](auto preceived, const std::string& s) {
+              preceived->push_back(s);
+            },
+            preceived, std::string(i % 17, 'a' + (i % 26)));
+        if (i % 5 == 0) {
+          world.async(
+              dest, [](auto pempty_count) { (*pempty_count)++; },
+              pempty_count);
+        }
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(empty_count == num_messages / 5);
+      YGM_ASSERT_RELEASE(received.size() == num_messages);
+      for (size_t i = 0; i < num_messages; ++i) {
+        YGM_ASSERT_RELEASE(received[i] == std::string(i % 17, 'a' + (i % 26)));
+      }
+    }
+
+    //
+    // Test async_bcast alongside runs
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int i = 0; i < 100; ++i) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+        world.async(
+            0, [](auto pcounter) { (*pcounter)++; }, pcounter);
+        world.async(
+            0, [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         size_t(100 * world.size() * (world.size() + 2)));
+    }
+
+    //
+    // Test stats report aggregated messages
+    {
+      std::stringstream ss;
+      world.stats_print("aggregate", ss);
+      if (world.rank0() && routing_scheme == "NONE") {
+        YGM_ASSERT_RELEASE(ss.str().find("GLOBAL_AGGREGATED_ASYNCS") !=
+                           std::string::npos);
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,56 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <sstream>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_BUFFER_POOL", "1", 1);
+
+  std::vector<std::string> huge_pages{"none", "thp", "hugetlb"};
+  for (const auto& huge_page : huge_pages) {
+    setenv("YGM_COMM_HUGE_PAGES", huge_page.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test send buffers are reused across many flushes
+    {
+      world.stats_reset();
+      size_t counter{};
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      size_t num_messages = 100000;
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "pooled buffer");
+              (*pcounter)++;
+            },
+            pcounter, std::string("pooled buffer"));
+        if (i % 10000 == 0) {
+          world.barrier();
+        }
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+
+      std::stringstream ss;
+      world.stats_print("pool", ss);
+      if (world.rank0()) {
+        YGM_ASSERT_RELEASE(ss.str().find("GLOBAL_POOL_HITS") !=
+                           std::string::npos);
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
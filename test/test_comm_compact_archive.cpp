@@ -0,0 +1,149 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <limits>
+#include <map>
+#include <sstream>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+struct point {
+  int    id;
+  double x;
+  double y;
+};
+
+size_t global_isend_bytes(ygm::comm& world) {
+  std::stringstream ss;
+  world.stats_print("archive", ss);
+  std::string line;
+  while (std::getline(ss, line)) {
+    if (line.rfind("GLOBAL_ISEND_BYTES", 0) == 0) {
+      return std::stoull(line.substr(line.find('=') + 1));
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    std::vector<size_t> isend_bytes;
+    for (std::string archive : {"default", "compact", "dictionary"}) {
+      setenv("YGM_COMM_ARCHIVE", archive.c_str(), 1);
+      ygm::comm world(MPI_COMM_WORLD);
+
+      //
+      // Test small integers and repeated string keys
+      {
+        world.stats_reset();
+        size_t counter{};
+        auto   pcounter     = world.make_ygm_ptr(counter);
+        int    num_messages = 10000;
+        for (int i = 0; i < num_messages; ++i) {
+          world.async(
+              i % world.size(),
+              [](auto pcounter, int64_t i, int32_t neg, uint64_t id,
+                 const std::string& key) {
+                YGM_ASSERT_RELEASE(neg == -i);
+                YGM_ASSERT_RELEASE(id == uint64_t(i) * 3);
+                YGM_ASSERT_RELEASE(key == "vertex_key_" + std::to_string(i % 7));
+                (*pcounter)++;
+              },
+              pcounter, int64_t(i), int32_t(-i), uint64_t(i) * 3,
+              "vertex_key_" + std::to_string(i % 7));
+        }
+        world.barrier();
+        YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                           size_t(num_messages) * world.size());
+        isend_bytes.push_back(global_isend_bytes(world));
+      }
+
+      //
+      // Test containers, extreme values and short strings
+      {
+        size_t counter{};
+        auto   pcounter = world.make_ygm_ptr(counter);
+        std::map<std::string, std::vector<int64_t>> m{
+            {"", {}},
+            {"ab", {std::numeric_limits<int64_t>::min(), -1, 0, 1}},
+            {"a longer key", {std::numeric_limits<int64_t>::max()}}};
+        for (int dest = 0; dest < world.size(); ++dest) {
+          for (int i = 0; i < 3; ++i) {
+            world.async(
+                dest,
+                [](auto pcounter, const auto& m, uint64_t big) {
+                  YGM_ASSERT_RELEASE(m.size() == 3);
+                  YGM_ASSERT_RELEASE(m.at("ab")[0] ==
+                                     std::numeric_limits<int64_t>::min());
+                  YGM_ASSERT_RELEASE(m.at("a longer key")[0] ==
+                                     std::numeric_limits<int64_t>::max());
+                  YGM_ASSERT_RELEASE(big ==
+                                     std::numeric_limits<uint64_t>::max());
+                  (*pcounter)++;
+                },
+                pcounter, m, std::numeric_limits<uint64_t>::max());
+          }
+        }
+        world.barrier();
+        YGM_ASSERT_RELEASE(counter == size_t(3 * world.size()));
+      }
+
+      //
+      // Test trivially packable arguments, integers of which are still varints
+      {
+        double sum{};
+        auto   psum         = world.make_ygm_ptr(sum);
+        int    num_messages = 1000;
+        for (int i = 0; i < num_messages; ++i) {
+          world.async(
+              i % world.size(),
+              [](auto psum, int i, uint64_t big, const point& p) {
+                YGM_ASSERT_RELEASE(p.id == i);
+                YGM_ASSERT_RELEASE(p.x == 0.5 * i && p.y == -0.5 * i);
+                YGM_ASSERT_RELEASE(big ==
+                                   std::numeric_limits<uint64_t>::max() - i);
+                *psum += p.x;
+              },
+              psum, i, std::numeric_limits<uint64_t>::max() - i,
+              point{i, 0.5 * i, -0.5 * i});
+        }
+        world.barrier();
+        YGM_ASSERT_RELEASE(world.all_reduce_sum(sum) ==
+                           0.25 * num_messages * (num_messages - 1) *
+                               world.size());
+      }
+
+      //
+      // Test async_bcast with string arguments
+      {
+        size_t counter{};
+        auto   pcounter = world.make_ygm_ptr(counter);
+        world.async_bcast(
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "broadcast string");
+              (*pcounter)++;
+            },
+            pcounter, std::string("broadcast string"));
+        world.barrier();
+        YGM_ASSERT_RELEASE(counter == size_t(world.size()));
+      }
+    }
+
+    // Only rank 0 prints stats
+    if (routing_scheme == "NONE" && isend_bytes[0] > 0) {
+      YGM_ASSERT_RELEASE(isend_bytes[1] < isend_bytes[0]);
+      YGM_ASSERT_RELEASE(isend_bytes[2] < isend_bytes[1]);
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <random>
+#include <ygm/comm.hpp>
+#include <ygm/detail/compression.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  //
+  // Test codec round trip on compressible, incompressible and overlapping data
+  {
+    ygm::detail::lz_codec    codec;
+    std::mt19937             gen(42);
+    std::vector<std::string> inputs;
+    inputs.push_back(std::string(100000, 'a'));
+    std::string keys;
+    for (int i = 0; i < 10000; ++i) {
+      keys += "key_" + std::to_string(i % 97) + ":" + std::to_string(i % 3);
+    }
+    inputs.push_back(keys);
+    std::string noise(70000, ' ');
+    for (auto& c : noise) {
+      c = char(gen());
+    }
+    inputs.push_back(noise);
+
+    for (const auto& input : inputs) {
+      ygm::detail::byte_vector compressed;
+      size_t                   compressed_size = codec.compress(
+          reinterpret_cast<const std::byte*>(input.data()), input.size(),
+          compressed);
+      if (compressed_size == 0) {
+        YGM_ASSERT_RELEASE(&input == &inputs.back());
+        continue;
+      }
+      YGM_ASSERT_RELEASE(compressed_size < input.size());
+      YGM_ASSERT_RELEASE(ygm::detail::lz_codec::decompressed_size(
+                             compressed.data()) == input.size());
+      std::string output(input.size(), ' ');
+      ygm::detail::lz_codec::decompress(
+          compressed.data(), compressed_size,
+          reinterpret_cast<std::byte*>(output.data()));
+      YGM_ASSERT_RELEASE(output == input);
+    }
+  }
+
+  setenv("YGM_COMM_COMPRESS", "all", 1);
+  setenv("YGM_COMM_COMPRESS_MIN_SIZE_KB", "0", 1);
+  setenv("YGM_COM_BUFFER_SIZE_KB", "64", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test compressible key/value traffic
+    {
+      size_t counter{};
+      size_t num_messages = 20000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::string& key, size_t value) {
+              YGM_ASSERT_RELEASE(key == "key_" + std::to_string(value));
+              (*pcounter)++;
+            },
+            pcounter, "key_" + std::to_string(i % 10), i % 10);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test incompressible traffic is sent raw
+    {
+      size_t          sum{};
+      auto            psum = world.make_ygm_ptr(sum);
+      std::mt19937_64 gen(world.rank());
+      size_t          local_sum{};
+      for (size_t i = 0; i < 5000; ++i) {
+        size_t value = gen();
+        local_sum += value;
+        world.async(
+            i % world.size(),
+            [](auto psum, size_t value) { (*psum) += value; }, psum, value);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(sum) ==
+                         world.all_reduce_sum(local_sum));
+    }
+
+    //
+    // Test async_bcast
+    {
+      size_t counter{};
+      int    num_bcasts = 100;
+      auto   pcounter   = world.make_ygm_ptr(counter);
+      for (int i = 0; i < num_bcasts; ++i) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == num_bcasts * world.size());
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,65 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <sstream>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+struct profiled_functor {
+  void operator()(const std::string &s) const {
+    YGM_ASSERT_RELEASE(s == "profiled");
+  }
+};
+
+int main(int argc, char **argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_PROFILE_HANDLERS", "1", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto &routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+    world.stats_reset();
+
+    //
+    // Test every rank sends a named functor to all ranks
+    {
+      size_t num_messages = 100;
+      for (int dest = 0; dest < world.size(); ++dest) {
+        for (size_t i = 0; i < num_messages; ++i) {
+          world.async(dest, profiled_functor(), std::string("profiled"));
+        }
+      }
+      world.barrier();
+
+      std::stringstream ss;
+      world.stats_print("profile", ss);
+      if (world.rank0()) {
+        std::string line;
+        bool        found = false;
+        while (std::getline(ss, line)) {
+          if (line.find("profiled_functor") != std::string::npos) {
+            std::stringstream row(line);
+            std::string       lid, calls, bytes;
+            std::getline(row, lid, ',');
+            std::getline(row, calls, ',');
+            std::getline(row, bytes, ',');
+            YGM_ASSERT_RELEASE(std::stoull(calls) ==
+                               num_messages * world.size() * world.size());
+            YGM_ASSERT_RELEASE(std::stoull(bytes) > 0);
+            found = true;
+          }
+        }
+        YGM_ASSERT_RELEASE(found);
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
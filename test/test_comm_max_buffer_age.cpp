@@ -0,0 +1,114 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_MAX_BUFFER_AGE_US", "1000", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test buffers left idle past the deadline are flushed by later asyncs
+    {
+      world.stats_reset();
+      size_t counter{};
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      int    partner      = (world.rank() + 1) % world.size();
+      size_t num_messages = 10;
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            partner, [](auto pcounter) { (*pcounter)++; }, pcounter);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == num_messages);
+
+      std::stringstream ss;
+      world.stats_print("max_buffer_age", ss);
+      if (world.rank0()) {
+        std::string stats = ss.str();
+        size_t      pos   = stats.find("GLOBAL_AGE_FLUSHES");
+        YGM_ASSERT_RELEASE(pos != std::string::npos);
+        size_t age_flushes =
+            std::stoull(stats.substr(stats.find('=', pos) + 1));
+        YGM_ASSERT_RELEASE(age_flushes > 0);
+        YGM_ASSERT_RELEASE(stats.find("MAX_BUFFER_AGE_US") !=
+                           std::string::npos);
+      }
+    }
+
+    //
+    // Test bulk traffic is unaffected by the deadline
+    {
+      size_t counter{};
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      size_t num_messages = 100000;
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(), [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+  }
+
+  //
+  // Test an idle buffer still expires while a destination queued ahead of it
+  // keeps being flushed out of order by the adaptive policy
+  {
+    setenv("YGM_COMM_ROUTING", "NONE", 1);
+    setenv("YGM_COMM_ADAPTIVE_BUFFERS", "1", 1);
+    setenv("YGM_COMM_LOCAL_BUFFER_SIZE_KB", "64", 1);
+    setenv("YGM_COMM_REMOTE_BUFFER_SIZE_KB", "64", 1);
+    ygm::comm world(MPI_COMM_WORLD);
+
+    if (world.size() >= 3) {
+      world.stats_reset();
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      int    hot      = (world.rank() + 1) % world.size();
+      int    idle     = (world.rank() + 2) % world.size();
+      auto   count    = [](auto pcounter, const std::string& s) {
+        (*pcounter)++;
+      };
+      world.async(hot, count, pcounter, std::string(1024, 'h'));
+      world.async(idle, count, pcounter, std::string(1024, 'i'));
+      auto start = std::chrono::steady_clock::now();
+      while (std::chrono::steady_clock::now() - start <
+             std::chrono::milliseconds(50)) {
+        world.async(hot, count, pcounter, std::string(1024, 'h'));
+      }
+      world.barrier();
+
+      std::stringstream ss;
+      world.stats_print("max_buffer_age_adaptive", ss);
+      if (world.rank0()) {
+        std::string stats = ss.str();
+        size_t      pos   = stats.find("MAX_BUFFER_AGE_US");
+        YGM_ASSERT_RELEASE(pos != std::string::npos);
+        double max_age = std::stod(stats.substr(stats.find('=', pos) + 1));
+        // The idle buffer waited for the barrier when expiry only checked
+        // the front of the dest queue
+        YGM_ASSERT_RELEASE(max_age < 25000);
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
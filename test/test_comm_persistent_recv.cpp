@@ -0,0 +1,60 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <string>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_PERSISTENT_RECV", "1", 1);
+  // Small buffers so that receive requests are restarted many times
+  setenv("YGM_COMM_LOCAL_BUFFER_SIZE_KB", "16", 1);
+  setenv("YGM_COMM_REMOTE_BUFFER_SIZE_KB", "16", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test asyncs arrive through restarted persistent receives
+    {
+      size_t counter{};
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      size_t num_messages = 100000;
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "persistent receive");
+              (*pcounter)++;
+            },
+            pcounter, std::string("persistent receive"));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test async_bcast across several barriers
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int round = 0; round < 10; ++round) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+        world.barrier();
+      }
+      YGM_ASSERT_RELEASE(counter == size_t(10 * world.size()));
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
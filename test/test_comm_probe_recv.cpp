@@ -0,0 +1,120 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <ygm/comm.hpp>
+#include <ygm/detail/recv_buffer_pool.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_PROBE_RECV", "1", 1);
+  // Receives larger than the configured irecv size are only possible when
+  // each receive is sized to its probed message
+  setenv("YGM_COMM_IRECV_SIZE_KB", "4", 1);
+  setenv("YGM_COMM_NUM_IRECVS", "2", 1);
+  setenv("YGM_COMM_LOCAL_BUFFER_SIZE_KB", "64", 1);
+  setenv("YGM_COMM_REMOTE_BUFFER_SIZE_KB", "64", 1);
+
+  //
+  // Test buffers are recycled within their size class
+  {
+    ygm::detail::recv_buffer_pool pool(2);
+    auto                          small = pool.acquire(100);
+    YGM_ASSERT_RELEASE(small->capacity() >= 100);
+    ygm::detail::byte_vector* small_ptr = small.get();
+    pool.release(std::move(small));
+    YGM_ASSERT_RELEASE(pool.cached_bytes() > 0);
+    auto reused = pool.acquire(200);
+    YGM_ASSERT_RELEASE(reused.get() == small_ptr);
+    YGM_ASSERT_RELEASE(reused->empty());
+    YGM_ASSERT_RELEASE(pool.cached_bytes() == 0);
+
+    auto large = pool.acquire(1024 * 1024);
+    YGM_ASSERT_RELEASE(large->capacity() >= 1024 * 1024);
+    YGM_ASSERT_RELEASE(large.get() != small_ptr);
+  }
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test all ranks async to all others
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async(
+            dest, [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == (size_t)world.size());
+    }
+
+    //
+    // Test many small messages, so receive buffers are reused across flushes
+    {
+      size_t counter{};
+      size_t num_messages = 100000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "probed");
+              (*pcounter)++;
+            },
+            pcounter, std::string("probed"));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test mixed message sizes, many larger than the irecv size
+    {
+      size_t counter{};
+      size_t num_messages = 200;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        // 8 bytes up to 256KB, well past the 4KB irecv size
+        std::vector<size_t> payload(size_t(1) << (i % 16), i);
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::vector<size_t>& v, size_t i) {
+              YGM_ASSERT_RELEASE(v.size() == size_t(1) << (i % 16));
+              YGM_ASSERT_RELEASE(v.front() == i && v.back() == i);
+              (*pcounter)++;
+            },
+            pcounter, payload, i);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test async_bcast
+    {
+      size_t counter{};
+      int    num_bcasts = 100;
+      auto   pcounter   = world.make_ygm_ptr(counter);
+      for (int i = 0; i < num_bcasts; ++i) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == num_bcasts * world.size());
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
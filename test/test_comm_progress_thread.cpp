@@ -0,0 +1,86 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  int provided;
+  YGM_ASSERT_MPI(
+      MPI_Init_thread(nullptr, nullptr, MPI_THREAD_MULTIPLE, &provided));
+  YGM_ASSERT_RELEASE(MPI_THREAD_MULTIPLE == provided);
+
+  setenv("YGM_COMM_PROGRESS_THREAD", "1", 1);
+  setenv("YGM_COM_BUFFER_SIZE_KB", "16", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test all ranks async to all others
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async(
+            dest, [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == (size_t)world.size());
+    }
+
+    //
+    // Test enough traffic to flush buffers before the barrier
+    {
+      size_t counter{};
+      size_t num_messages = 10000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "progress");
+              (*pcounter)++;
+            },
+            pcounter, std::string("progress"));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test async_bcast
+    {
+      size_t counter{};
+      int    num_bcasts = 100;
+      auto   pcounter   = world.make_ygm_ptr(counter);
+      for (int i = 0; i < num_bcasts; ++i) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == num_bcasts * world.size());
+    }
+
+    //
+    // Test wait_until
+    {
+      static bool done = false;
+      world.cf_barrier();
+      world.async_bcast([]() { done = true; });
+      world.local_wait_until([]() { return done; });
+      world.barrier();
+      YGM_ASSERT_RELEASE(done);
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
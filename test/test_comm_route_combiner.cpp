@@ -0,0 +1,105 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <ygm/comm.hpp>
+#include <ygm/container/map.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_ROUTE_COMBINE", "1", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR", "GRID"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test messages with a registered combiner still arrive exactly once
+    {
+      std::map<std::string, size_t> sums;
+      auto                          psums = world.make_ygm_ptr(sums);
+      auto add = [](auto psums, const std::string& key, size_t value) {
+        (*psums)[key] += value;
+      };
+      world.register_route_combiner<decltype(psums), std::string, size_t>(
+          add, [](size_t a, size_t b) { return a + b; });
+      world.stats_reset();
+
+      size_t num_messages = 10000;
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(i % world.size(), add, psums,
+                    std::string("key_") + std::to_string(i % 7), size_t(1));
+      }
+      world.barrier();
+
+      size_t total = 0;
+      for (const auto& kv : sums) {
+        total += kv.second;
+      }
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(total) ==
+                         num_messages * world.size());
+
+      std::stringstream ss;
+      world.stats_print("route_combiner", ss);
+      if (world.rank0() && routing_scheme != "NONE") {
+        YGM_ASSERT_RELEASE(ss.str().find("GLOBAL_ROUTE_COMBINED") !=
+                           std::string::npos);
+      }
+    }
+
+    //
+    // Test map reductions, which register a combiner
+    {
+      ygm::container::map<std::string, size_t> counts(world);
+      for (size_t i = 0; i < 1000; ++i) {
+        counts.async_reduce(std::string("key_") + std::to_string(i % 13),
+                            size_t(1),
+                            [](size_t a, size_t b) { return a + b; });
+      }
+      world.barrier();
+
+      size_t total = 0;
+      counts.for_all([&total](const std::string& key, size_t count) {
+        total += count;
+      });
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(total) ==
+                         size_t(1000 * world.size()));
+    }
+
+    //
+    // Test reducers capturing different state per call are each applied with
+    // their own state
+    {
+      ygm::container::map<std::string, size_t> capped(world);
+      for (size_t i = 0; i < 1000; ++i) {
+        size_t      cap = (i % 2 == 0) ? 1000000 : 5;
+        std::string key = (i % 2 == 0) ? "large" : "small";
+        capped.async_reduce(key, size_t(1), [cap](size_t a, size_t b) {
+          return std::min(a + b, cap);
+        });
+      }
+      world.barrier();
+
+      capped.for_all([&world](const std::string& key, size_t value) {
+        if (key == "small") {
+          YGM_ASSERT_RELEASE(value == 5);
+        } else {
+          YGM_ASSERT_RELEASE(value == size_t(500 * world.size()));
+        }
+      });
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
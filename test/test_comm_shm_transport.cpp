@@ -0,0 +1,126 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  setenv("YGM_COMM_SHM_TRANSPORT", "1", 1);
+  // Small rings exercise wrap-around and the fallback to MPI when full
+  setenv("YGM_COMM_SHM_RING_SIZE_KB", "8", 1);
+  setenv("YGM_COM_BUFFER_SIZE_KB", "16", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test all ranks async to all others
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async(
+            dest, [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == (size_t)world.size());
+    }
+
+    //
+    // Test enough traffic to flush buffers before the barrier
+    {
+      size_t counter{};
+      size_t num_messages = 10000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto pcounter, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == "progress");
+              (*pcounter)++;
+            },
+            pcounter, std::string("progress"));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test messages larger than a ring
+    {
+      size_t           counter{};
+      auto             pcounter = world.make_ygm_ptr(counter);
+      std::vector<int> large(16 * 1024, world.rank());
+      world.async(
+          (world.rank() + 1) % world.size(),
+          [](auto pcounter, const std::vector<int>& v, int from) {
+            YGM_ASSERT_RELEASE(v.size() == 16 * 1024);
+            YGM_ASSERT_RELEASE(v.back() == from);
+            (*pcounter)++;
+          },
+          pcounter, large, world.rank());
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == 1);
+    }
+
+    //
+    // Test messages to one dest arrive in send order while full rings and
+    // oversized buffers push some of them through MPI
+    if (routing_scheme == "NONE") {
+      size_t next_expected{};
+      auto   pnext        = world.make_ygm_ptr(next_expected);
+      int    dest         = (world.rank() + 1) % world.size();
+      size_t num_messages = 2000;
+      for (size_t i = 0; i < num_messages; ++i) {
+        size_t payload_size = (i % 100 == 0) ? 4096 : 16;
+        world.async(
+            dest,
+            [](auto pnext, size_t i, const std::vector<size_t>& v) {
+              YGM_ASSERT_RELEASE(*pnext == i);
+              YGM_ASSERT_RELEASE(v.back() == i);
+              (*pnext)++;
+            },
+            pnext, i, std::vector<size_t>(payload_size, i));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(next_expected == num_messages);
+    }
+
+    //
+    // Test async_bcast
+    {
+      size_t counter{};
+      int    num_bcasts = 100;
+      auto   pcounter   = world.make_ygm_ptr(counter);
+      for (int i = 0; i < num_bcasts; ++i) {
+        world.async_bcast([](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == num_bcasts * world.size());
+    }
+
+    //
+    // Test wait_until
+    {
+      static bool done = false;
+      world.cf_barrier();
+      world.async_bcast([]() { done = true; });
+      world.local_wait_until([]() { return done; });
+      world.barrier();
+      YGM_ASSERT_RELEASE(done);
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test local work overlaps a split-phase barrier
+    {
+      size_t counter{};
+      size_t num_messages = 10000;
+      auto   pcounter     = world.make_ygm_ptr(counter);
+      for (size_t i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(), [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+
+      world.barrier_begin();
+      size_t local_work{};
+      while (!world.barrier_test()) {
+        ++local_work;
+      }
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_messages * world.size());
+    }
+
+    //
+    // Test messages sent from handlers during a split-phase barrier
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      world.async(
+          (world.rank() + 1) % world.size(),
+          [](ygm::comm* pcomm, auto pcounter) {
+            (*pcounter)++;
+            pcomm->async(
+                (pcomm->rank() + 1) % pcomm->size(),
+                [](auto pcounter) { (*pcounter)++; }, pcounter);
+          },
+          pcounter);
+
+      world.barrier_begin();
+      while (!world.barrier_test()) {
+      }
+      YGM_ASSERT_RELEASE(counter == 2);
+    }
+
+    //
+    // Test split-phase and regular barriers interleave
+    {
+      for (int i = 0; i < 10; ++i) {
+        world.barrier_begin();
+        while (!world.barrier_test()) {
+        }
+        world.barrier();
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
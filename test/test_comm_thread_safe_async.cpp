@@ -0,0 +1,125 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  int provided;
+  YGM_ASSERT_MPI(
+      MPI_Init_thread(nullptr, nullptr, MPI_THREAD_MULTIPLE, &provided));
+  YGM_ASSERT_RELEASE(MPI_THREAD_MULTIPLE == provided);
+
+  setenv("YGM_COMM_THREAD_SAFE_ASYNC", "1", 1);
+  setenv("YGM_COMM_THREAD_BUFFER_SIZE_KB", "4", 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test many threads async to all ranks
+    {
+      size_t counter{};
+      auto   pcounter    = world.make_ygm_ptr(counter);
+      int    num_threads = 4;
+      size_t num_sends   = 1000;
+
+      std::vector<std::thread> threads;
+      for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&world, pcounter, t, num_sends]() {
+          for (size_t i = 0; i < num_sends; ++i) {
+            world.async(
+                (i + t) % world.size(),
+                [](auto pcounter, const std::string& s) {
+                  YGM_ASSERT_RELEASE(s == "thread");
+                  (*pcounter)++;
+                },
+                pcounter, std::string("thread"));
+            if (i % 100 == 0) {
+              world.local_progress();
+            }
+          }
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(counter) ==
+                         num_threads * num_sends * world.size());
+    }
+
+    //
+    // Test recursive asyncs issued from handlers
+    {
+      static size_t counter = 0;
+      counter               = 0;
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&world]() {
+          world.async(world.rank(), [](ygm::comm* pcomm) {
+            counter++;
+            pcomm->async((pcomm->rank() + 1) % pcomm->size(),
+                         []() { counter++; });
+          });
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == 4);
+    }
+  }
+
+  //
+  // Test asyncs from other threads and the progress thread are traced
+  {
+    std::string prefix =
+        (std::filesystem::temp_directory_path() / "ygm_test_thread_trace")
+            .string();
+    setenv("YGM_COMM_TRACE_FILE", prefix.c_str(), 1);
+    setenv("YGM_COMM_PROGRESS_THREAD", "1", 1);
+    int    rank;
+    size_t num_sends = 100;
+    {
+      ygm::comm world(MPI_COMM_WORLD);
+      rank = world.rank();
+      std::thread thread([&world, num_sends]() {
+        for (size_t i = 0; i < num_sends; ++i) {
+          world.async(i % world.size(), []() {});
+        }
+      });
+      thread.join();
+      world.barrier();
+    }
+    unsetenv("YGM_COMM_TRACE_FILE");
+    unsetenv("YGM_COMM_PROGRESS_THREAD");
+
+    std::string   trace_file = prefix + "." + std::to_string(rank) + ".json";
+    std::ifstream ifs(trace_file);
+    std::string   line;
+    size_t        num_asyncs   = 0;
+    size_t        num_progress = 0;
+    while (std::getline(ifs, line)) {
+      num_asyncs += line.find("\"name\":\"async\"") != std::string::npos;
+      num_progress += line.find("\"name\":\"progress\"") != std::string::npos;
+    }
+    YGM_ASSERT_RELEASE(num_asyncs == num_sends);
+    YGM_ASSERT_RELEASE(num_progress > 0);
+    std::filesystem::remove(trace_file);
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
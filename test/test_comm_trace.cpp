@@ -0,0 +1,78 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <ygm/comm.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  int rank;
+  YGM_ASSERT_MPI(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  std::string prefix =
+      (std::filesystem::temp_directory_path() / "ygm_test_comm_trace")
+          .string();
+  std::string trace_file = prefix + "." + std::to_string(rank) + ".json";
+  setenv("YGM_COMM_TRACE_FILE", prefix.c_str(), 1);
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    //
+    // Test trace is written at comm destruction
+    {
+      ygm::comm world(MPI_COMM_WORLD);
+      static size_t counter = 0;
+      counter               = 0;
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async(dest, []() { counter++; });
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == size_t(world.size()));
+    }
+
+    std::ifstream     ifs(trace_file);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    std::string trace = ss.str();
+    YGM_ASSERT_RELEASE(trace.find("{\"traceEvents\":[") == 0);
+    YGM_ASSERT_RELEASE(trace.find("\"name\":\"async\"") != std::string::npos);
+    YGM_ASSERT_RELEASE(trace.find("\"name\":\"flush\"") != std::string::npos);
+    YGM_ASSERT_RELEASE(trace.find("\"name\":\"handler\"") != std::string::npos);
+    YGM_ASSERT_RELEASE(trace.find("\"name\":\"barrier_round\"") !=
+                       std::string::npos);
+    std::filesystem::remove(trace_file);
+  }
+
+  //
+  // Test a small ring keeps only the newest events
+  {
+    setenv("YGM_COMM_TRACE_EVENTS", "16", 1);
+    {
+      ygm::comm world(MPI_COMM_WORLD);
+      for (int i = 0; i < 1000; ++i) {
+        world.async(i % world.size(), []() {});
+      }
+      world.barrier();
+    }
+    std::ifstream ifs(trace_file);
+    std::string   line;
+    size_t        num_events = 0;
+    while (std::getline(ifs, line)) {
+      if (line.rfind("{\"name\"", 0) == 0) {
+        ++num_events;
+      }
+    }
+    YGM_ASSERT_RELEASE(num_events == 16);
+    std::filesystem::remove(trace_file);
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
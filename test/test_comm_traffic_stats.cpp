@@ -0,0 +1,82 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <sstream>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    //
+    // Test CSV matrix counts every async by source and destination
+    {
+      setenv("YGM_COMM_TRAFFIC_STATS", "csv", 1);
+      ygm::comm world(MPI_COMM_WORLD);
+      world.stats_reset();
+
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        for (int i = 0; i <= dest; ++i) {
+          world.async(
+              dest, [](auto pcounter) { (*pcounter)++; }, pcounter);
+        }
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == size_t(world.rank() + 1) * world.size());
+
+      std::stringstream ss;
+      world.stats_print("traffic", ss);
+      if (world.rank0()) {
+        std::string line;
+        int         async_rows = 0;
+        while (std::getline(ss, line)) {
+          if (line.rfind("async_count,", 0) != 0) {
+            continue;
+          }
+          std::stringstream row(line);
+          std::string       cell;
+          std::getline(row, cell, ',');  // matrix name
+          std::getline(row, cell, ',');  // source rank
+          int dest = 0;
+          while (std::getline(row, cell, ',')) {
+            YGM_ASSERT_RELEASE(std::stoull(cell) == size_t(dest + 1));
+            ++dest;
+          }
+          YGM_ASSERT_RELEASE(dest == world.size());
+          ++async_rows;
+        }
+        YGM_ASSERT_RELEASE(async_rows == world.size());
+      }
+    }
+
+    //
+    // Test JSON output
+    {
+      setenv("YGM_COMM_TRAFFIC_STATS", "json", 1);
+      ygm::comm world(MPI_COMM_WORLD);
+
+      world.async_bcast([]() {});
+      world.barrier();
+
+      std::stringstream ss;
+      world.stats_print("traffic", ss);
+      if (world.rank0()) {
+        YGM_ASSERT_RELEASE(ss.str().find("{\"ranks\":") != std::string::npos);
+        YGM_ASSERT_RELEASE(ss.str().find("\"handler_time_ns_histogram\":[{") !=
+                           std::string::npos);
+      }
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,131 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <string_view>
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+struct point {
+  int    id;
+  double x;
+  double y;
+};
+
+// Trivially copyable, but its own save/load must still be used
+struct tracked {
+  int  value;
+  bool loaded = false;
+
+  template <class Archive>
+  void save(Archive& archive) const {
+    archive(value);
+  }
+
+  template <class Archive>
+  void load(Archive& archive) {
+    archive(value);
+    loaded = true;
+  }
+};
+
+enum class color { red, green };
+
+static_assert(ygm::detail::is_trivially_packable_v<ygm::ygm_ptr<int>, int,
+                                                     double, point, color>);
+static_assert(!ygm::detail::is_trivially_packable_v<int, std::string>);
+static_assert(!ygm::detail::is_trivially_packable_v<tracked>);
+static_assert(!ygm::detail::is_trivially_packable_v<std::string_view>);
+static_assert(!ygm::detail::is_trivially_packable_v<int*>);
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test trivially copyable arguments, including a struct without serialize
+    {
+      double sum{};
+      auto   psum         = world.make_ygm_ptr(sum);
+      int    num_messages = 1000;
+      for (int i = 0; i < num_messages; ++i) {
+        world.async(
+            i % world.size(),
+            [](auto psum, int i, const point& p) {
+              YGM_ASSERT_RELEASE(p.id == i);
+              YGM_ASSERT_RELEASE(p.x == 0.5 * i && p.y == -0.5 * i);
+              *psum += p.x;
+            },
+            psum, i, point{i, 0.5 * i, -0.5 * i});
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(sum) ==
+                         0.25 * num_messages * (num_messages - 1) *
+                             world.size());
+    }
+
+    //
+    // Test mixed trivial and serialized arguments
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async(
+            dest,
+            [](auto pcounter, int i, const std::string& s) {
+              YGM_ASSERT_RELEASE(s == std::to_string(i));
+              (*pcounter)++;
+            },
+            pcounter, dest, std::to_string(dest));
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == size_t(world.size()));
+    }
+
+    //
+    // Test trivially copyable arguments with custom serialization use it
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async(
+            dest,
+            [](auto pcounter, const tracked& t, color c) {
+              YGM_ASSERT_RELEASE(t.loaded);
+              YGM_ASSERT_RELEASE(c == color::green);
+              (*pcounter) += t.value;
+            },
+            pcounter, tracked{1}, color::green);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == size_t(world.size()));
+    }
+
+    //
+    // Test async_bcast with trivially copyable arguments
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      if (world.rank0()) {
+        world.async_bcast(
+            [](auto pcounter, const point& p) {
+              YGM_ASSERT_RELEASE(p.id == 7 && p.x == 1.0 && p.y == 2.0);
+              (*pcounter)++;
+            },
+            pcounter, point{7, 1.0, 2.0});
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == 1);
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
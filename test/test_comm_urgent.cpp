@@ -0,0 +1,69 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <ygm/comm.hpp>
+#include <ygm/detail/ygm_ptr.hpp>
+
+int main(int argc, char** argv) {
+  YGM_ASSERT_MPI(MPI_Init(nullptr, nullptr));
+
+  std::vector<std::string> routing_schemes{"NONE", "NR", "NLNR"};
+  for (const auto& routing_scheme : routing_schemes) {
+    setenv("YGM_COMM_ROUTING", routing_scheme.c_str(), 1);
+
+    ygm::comm world(MPI_COMM_WORLD);
+
+    //
+    // Test a request/response round trip completes without a barrier while
+    // bulk traffic is buffered
+    {
+      size_t bulk_counter{};
+      auto   pbulk_counter = world.make_ygm_ptr(bulk_counter);
+      int    reply{-1};
+      auto   preply = world.make_ygm_ptr(reply);
+      world.barrier();
+
+      for (int i = 0; i < 1000; ++i) {
+        world.async(
+            i % world.size(), [](auto pcounter) { (*pcounter)++; },
+            pbulk_counter);
+      }
+
+      int partner = (world.rank() + 1) % world.size();
+      world.async_urgent(
+          partner,
+          [](ygm::comm* pcomm, auto preply, int from) {
+            pcomm->async_urgent(
+                from, [](auto preply, int r) { *preply = r; }, preply,
+                pcomm->rank());
+          },
+          preply, world.rank());
+
+      world.local_wait_until([&reply]() { return reply >= 0; });
+      YGM_ASSERT_RELEASE(reply == partner);
+
+      world.barrier();
+      YGM_ASSERT_RELEASE(world.all_reduce_sum(bulk_counter) ==
+                         size_t(1000 * world.size()));
+    }
+
+    //
+    // Test urgent messages are counted by barrier
+    {
+      size_t counter{};
+      auto   pcounter = world.make_ygm_ptr(counter);
+      for (int dest = 0; dest < world.size(); ++dest) {
+        world.async_urgent(
+            dest, [](auto pcounter) { (*pcounter)++; }, pcounter);
+      }
+      world.barrier();
+      YGM_ASSERT_RELEASE(counter == size_t(world.size()));
+    }
+  }
+
+  YGM_ASSERT_MPI(MPI_Finalize());
+  return 0;
+}
@@ -0,0 +1,146 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <ygm/container/detail/flat_hash_map.hpp>
+#include <ygm/container/detail/lookup_key.hpp>
+#include <ygm/detail/assert.hpp>
+
+using ygm::container::detail::flat_hash_map;
+
+template <typename Key, typename Value>
+void check_equal(const flat_hash_map<Key, Value>      &table,
+                 const std::unordered_map<Key, Value> &expected) {
+  YGM_ASSERT_RELEASE(table.size() == expected.size());
+  size_t iterated = 0;
+  for (const auto &kv : table) {
+    auto itr = expected.find(kv.first);
+    YGM_ASSERT_RELEASE(itr != expected.end());
+    YGM_ASSERT_RELEASE(itr->second == kv.second);
+    ++iterated;
+  }
+  YGM_ASSERT_RELEASE(iterated == expected.size());
+}
+
+int main() {
+  //
+  // Test basic operations
+  {
+    flat_hash_map<std::string, int> table;
+    YGM_ASSERT_RELEASE(table.empty());
+    YGM_ASSERT_RELEASE(table.find("dog") == table.end());
+    YGM_ASSERT_RELEASE(table.begin() == table.end());
+
+    YGM_ASSERT_RELEASE(table.insert({"dog", 1}).second);
+    YGM_ASSERT_RELEASE(!table.insert({"dog", 2}).second);
+    YGM_ASSERT_RELEASE(table.at("dog") == 1);
+    table.insert_or_assign("dog", 3);
+    YGM_ASSERT_RELEASE(table.at("dog") == 3);
+    table["cat"] += 5;
+    YGM_ASSERT_RELEASE(table.count("cat") == 1);
+    YGM_ASSERT_RELEASE(table.at("cat") == 5);
+
+    auto range = table.equal_range("cat");
+    YGM_ASSERT_RELEASE(std::distance(range.first, range.second) == 1);
+    range = table.equal_range("bird");
+    YGM_ASSERT_RELEASE(range.first == range.second);
+
+    bool threw = false;
+    try {
+      table.at("bird");
+    } catch (const std::out_of_range &) {
+      threw = true;
+    }
+    YGM_ASSERT_RELEASE(threw);
+
+    table.erase(table.find("dog"));
+    YGM_ASSERT_RELEASE(table.erase("cat") == 1);
+    YGM_ASSERT_RELEASE(table.erase("cat") == 0);
+    YGM_ASSERT_RELEASE(table.empty());
+  }
+
+  //
+  // Test random inserts, erases and lookups against std::unordered_map,
+  // including keys sharing their low bits as on one rank of a ygm map
+  for (uint64_t stride : {uint64_t(1), uint64_t(64), uint64_t(1) << 32}) {
+    flat_hash_map<uint64_t, uint64_t>      table;
+    std::unordered_map<uint64_t, uint64_t> expected;
+    std::mt19937_64                        rng(stride);
+    for (size_t i = 0; i < 200000; ++i) {
+      uint64_t key = (rng() % 5000) * stride;
+      switch (rng() % 4) {
+        case 0:
+        case 1:
+          table[key] += i;
+          expected[key] += i;
+          break;
+        case 2:
+          YGM_ASSERT_RELEASE(table.erase(key) == expected.erase(key));
+          break;
+        case 3:
+          YGM_ASSERT_RELEASE(table.count(key) == expected.count(key));
+          break;
+      }
+    }
+    check_equal(table, expected);
+
+    //
+    // Test copies, moves and clear
+    flat_hash_map<uint64_t, uint64_t> copy(table);
+    check_equal(copy, expected);
+    flat_hash_map<uint64_t, uint64_t> moved(std::move(copy));
+    check_equal(moved, expected);
+    table.clear();
+    YGM_ASSERT_RELEASE(table.size() == 0);
+    YGM_ASSERT_RELEASE(table.begin() == table.end());
+    table.swap(moved);
+    check_equal(table, expected);
+  }
+
+  //
+  // Test transparent lookup by std::string_view
+  {
+    using ygm::container::detail::lookup_equal;
+    using ygm::container::detail::lookup_hash;
+    flat_hash_map<std::string, int, lookup_hash<std::string>,
+                  lookup_equal<std::string>>
+        table;
+    table["dog"] = 1;
+    table["cat"] = 2;
+
+    std::string_view dog("dog");
+    YGM_ASSERT_RELEASE(table.count(dog) == 1);
+    YGM_ASSERT_RELEASE(table.find(dog)->second == 1);
+    YGM_ASSERT_RELEASE(table.at(std::string_view("cat")) == 2);
+    YGM_ASSERT_RELEASE(table.count(std::string_view("bird")) == 0);
+    auto range = table.equal_range(dog);
+    YGM_ASSERT_RELEASE(std::distance(range.first, range.second) == 1);
+    YGM_ASSERT_RELEASE(table.erase(dog) == 1);
+    table.erase(table.find(std::string_view("cat")));
+    YGM_ASSERT_RELEASE(table.empty());
+  }
+
+  //
+  // Test tombstones are reclaimed when the same keys are reinserted
+  {
+    flat_hash_map<int, std::string> table;
+    for (int round = 0; round < 100; ++round) {
+      for (int i = 0; i < 1000; ++i) {
+        table.try_emplace(i, std::to_string(i));
+      }
+      for (int i = 0; i < 1000; ++i) {
+        YGM_ASSERT_RELEASE(table.at(i) == std::to_string(i));
+        table.erase(i);
+      }
+    }
+    YGM_ASSERT_RELEASE(table.empty());
+    YGM_ASSERT_RELEASE(table.capacity() <= 4096);
+  }
+
+  return 0;
+}
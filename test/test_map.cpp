@@ -488,5 +488,105 @@ int main(int argc, char **argv) {
     YGM_ASSERT_RELEASE(smap2.count("red") == 1);
   }
 
+  //
+  // Test flat_storage
+  {
+    using flat_map =
+        ygm::container::map<int, int, ygm::container::flat_storage>;
+    static_assert(std::is_same_v<flat_map::storage_type,
+                                 ygm::container::flat_storage>);
+
+    flat_map imap(world);
+    int      num_keys = 1000;
+    for (int i = 0; i < num_keys; ++i) {
+      imap.async_insert(i, i);
+      imap.async_reduce(num_keys + i, 1, std::plus<int>());
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(imap.size() == 2 * num_keys);
+
+    imap.for_all([&world, num_keys](const auto &key, const auto &value) {
+      if (key < num_keys) {
+        YGM_ASSERT_RELEASE(value == key);
+      } else {
+        YGM_ASSERT_RELEASE(value == world.size());
+      }
+    });
+
+    for (int i = 0; i < num_keys; ++i) {
+      imap.async_visit(i, [](const auto &key, auto &value) { value += 1; });
+      imap.async_erase(num_keys + i);
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(imap.size() == num_keys);
+    YGM_ASSERT_RELEASE(imap.count(num_keys) == 0);
+    imap.for_all([&world](const auto &key, const auto &value) {
+      YGM_ASSERT_RELEASE(value == key + world.size());
+    });
+
+    flat_map imap2(world);
+    imap2.swap(imap);
+    YGM_ASSERT_RELEASE(imap.size() == 0);
+    YGM_ASSERT_RELEASE(imap2.size() == num_keys);
+  }
+
+  //
+  // Test std::string_view lookups
+  {
+    ygm::container::map<std::string, int> smap(world);
+    ygm::container::map<std::string, int, ygm::container::flat_storage> fmap(
+        world);
+    smap.async_insert("dog", 1);
+    fmap.async_insert("dog", 1);
+    world.barrier();
+
+    std::string_view dog("dog");
+    std::string_view cat("cat");
+    YGM_ASSERT_RELEASE(smap.count(dog) == 1);
+    YGM_ASSERT_RELEASE(fmap.count(dog) == 1);
+    YGM_ASSERT_RELEASE(smap.partitioner.owner(dog) ==
+                       smap.partitioner.owner(std::string("dog")));
+
+    auto visitor = [](const std::string &key, int &value) { value += 1; };
+    smap.async_visit_if_contains(dog, visitor);
+    fmap.async_visit_if_contains(dog, visitor);
+    smap.async_visit(cat, visitor);
+    fmap.async_visit(cat, visitor);
+    world.barrier();
+
+    smap.for_all([&world](const auto &key, const auto &value) {
+      if (key == "dog") {
+        YGM_ASSERT_RELEASE(value == world.size() + 1);
+      } else {
+        YGM_ASSERT_RELEASE(key == "cat" && value == world.size());
+      }
+    });
+    YGM_ASSERT_RELEASE(fmap.size() == 2);
+    YGM_ASSERT_RELEASE(fmap.count(cat) == 1);
+  }
+
+  //
+  // Test async_visit_batch
+  {
+    ygm::container::map<int, int> imap(world);
+    std::vector<int>               keys;
+    for (int i = 0; i < 100; ++i) {
+      keys.push_back(i);
+      if (i % 10 == 0) {
+        keys.push_back(i);
+      }
+    }
+    imap.async_visit_batch(
+        keys, [](const int &key, int &value, int add) { value += add; }, 2);
+    imap.async_visit_batch({}, [](const int &key, int &value) { value = -1; });
+    world.barrier();
+
+    YGM_ASSERT_RELEASE(imap.size() == 100);
+    imap.for_all([&world](const int &key, const int &value) {
+      int expected = (key % 10 == 0 ? 4 : 2) * world.size();
+      YGM_ASSERT_RELEASE(value == expected);
+    });
+  }
+
   return 0;
 }
@@ -242,5 +242,29 @@ int main(int argc, char** argv) {
     }
   }
 
+  //
+  // Test flat_storage
+  {
+    ygm::container::multiset<int, ygm::container::flat_storage> iset(world);
+    int num_items = 1000;
+    for (int i = 0; i < num_items; ++i) {
+      iset.async_insert(i);
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(iset.size() == num_items * world.size());
+    YGM_ASSERT_RELEASE(iset.count(num_items / 2) == world.size());
+
+    iset.async_insert(num_items);
+    world.barrier();
+    YGM_ASSERT_RELEASE(iset.count(num_items) == world.size());
+
+    if (world.rank0()) {
+      iset.async_erase(num_items);
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(iset.count(num_items) == 0);
+    YGM_ASSERT_RELEASE(iset.size() == num_items * world.size());
+  }
+
   return 0;
 }
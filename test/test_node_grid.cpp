@@ -0,0 +1,52 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <set>
+#include <vector>
+#include <ygm/detail/assert.hpp>
+#include <ygm/detail/node_grid.hpp>
+
+int main() {
+  for (int num_nodes = 1; num_nodes <= 200; ++num_nodes) {
+    ygm::detail::node_grid grid(num_nodes);
+    YGM_ASSERT_RELEASE(grid.cols() * grid.rows() >= num_nodes);
+    YGM_ASSERT_RELEASE((grid.cols() - 1) * (grid.cols() - 1) < num_nodes);
+
+    std::vector<std::set<int>> peers(num_nodes);
+    for (int src = 0; src < num_nodes; ++src) {
+      for (int dest = 0; dest < num_nodes; ++dest) {
+        if (src == dest) {
+          continue;
+        }
+        //
+        // Test every route reaches dest in at most two hops, each staying in
+        // the grid and along a row or a column
+        int node = src;
+        int hops = 0;
+        while (node != dest) {
+          int next = grid.next_node(node, dest);
+          YGM_ASSERT_RELEASE(next >= 0 && next < num_nodes);
+          YGM_ASSERT_RELEASE(next != node);
+          YGM_ASSERT_RELEASE(grid.row(next) == grid.row(node) ||
+                             grid.col(next) == grid.col(node));
+          peers[node].insert(next);
+          node = next;
+          ++hops;
+        }
+        YGM_ASSERT_RELEASE(hops <= 2);
+      }
+    }
+
+    //
+    // Test each node only sends to its own row and column
+    for (int node = 0; node < num_nodes; ++node) {
+      YGM_ASSERT_RELEASE(peers[node].size() <=
+                         size_t(grid.cols() + grid.rows() - 2));
+    }
+  }
+
+  return 0;
+}
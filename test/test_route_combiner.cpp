@@ -0,0 +1,104 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <map>
+#include <string>
+#include <vector>
+#include <ygm/detail/assert.hpp>
+#include <ygm/detail/route_combiner.hpp>
+
+struct handler {
+  int scale;
+  void operator()(const std::string& key, size_t value) const {}
+};
+
+template <typename Lambda, typename... Args>
+void pack_message(ygm::detail::byte_vector&            buffer,
+                  const ygm::detail::archive_options& options, uint16_t lid,
+                  const Lambda& l, const Args&... args) {
+  buffer.push_bytes(&lid, sizeof(lid));
+  if constexpr (!std::is_empty_v<Lambda>) {
+    buffer.push_bytes(&l, sizeof(Lambda));
+  }
+  ygm::detail::pack_arguments(buffer, options, args...);
+}
+
+int main() {
+  auto plus = [](size_t a, size_t b) { return a + b; };
+
+  //
+  // Test messages agreeing on dest and key are merged, others are kept
+  for (bool compact : {false, true}) {
+    ygm::detail::archive_options options{compact, nullptr};
+    auto empty_lambda = [](const std::string& key, size_t value) {};
+    ygm::detail::typed_route_combiner<decltype(empty_lambda), decltype(plus),
+                                      std::string, size_t>
+        combiner(7, plus);
+
+    ygm::detail::byte_vector buffer;
+    std::vector<int>         dests;
+    for (size_t i = 0; i < 100; ++i) {
+      buffer.clear();
+      pack_message(buffer, options, 7, empty_lambda,
+                   std::string("key_") + std::to_string(i % 5), i);
+      cereal::YGMInputArchive iarchive(buffer.data(), buffer.size(), options);
+      uint16_t                lid;
+      iarchive.loadBinary(&lid, sizeof(lid));
+      bool merged = combiner.absorb(int(i % 2), iarchive);
+      YGM_ASSERT_RELEASE(iarchive.empty());
+      YGM_ASSERT_RELEASE(merged == (i >= 10));
+    }
+    YGM_ASSERT_RELEASE(combiner.pending_count() == 10);
+
+    std::map<std::pair<int, std::string>, size_t> sums;
+    combiner.drain(options, [&sums, &options](int dest, auto& message) {
+      cereal::YGMInputArchive iarchive(message.data(), message.size(),
+                                       options);
+      uint16_t                lid;
+      iarchive.loadBinary(&lid, sizeof(lid));
+      YGM_ASSERT_RELEASE(lid == 7);
+      std::tuple<std::string, size_t> args;
+      ygm::detail::unpack_arguments(iarchive, args);
+      YGM_ASSERT_RELEASE(iarchive.empty());
+      sums[{dest, std::get<0>(args)}] += std::get<1>(args);
+    });
+    YGM_ASSERT_RELEASE(combiner.pending_count() == 0);
+    YGM_ASSERT_RELEASE(sums.size() == 10);
+    for (size_t i = 0; i < 100; ++i) {
+      sums[{int(i % 2), std::string("key_") + std::to_string(i % 5)}] -= i;
+    }
+    for (const auto& kv : sums) {
+      YGM_ASSERT_RELEASE(kv.second == 0);
+    }
+  }
+
+  //
+  // Test function objects with different state are never merged
+  {
+    ygm::detail::typed_route_combiner<handler, decltype(plus), std::string,
+                                      size_t>
+                             combiner(3, plus);
+    ygm::detail::byte_vector buffer;
+    for (int scale = 0; scale < 4; ++scale) {
+      buffer.clear();
+      pack_message(buffer, {}, 3, handler{scale}, std::string("same key"),
+                   size_t(1));
+      cereal::YGMInputArchive iarchive(buffer.data(), buffer.size());
+      uint16_t                lid;
+      iarchive.loadBinary(&lid, sizeof(lid));
+      YGM_ASSERT_RELEASE(!combiner.absorb(0, iarchive));
+    }
+    YGM_ASSERT_RELEASE(combiner.pending_count() == 4);
+    int expected_scale = 0;
+    combiner.drain({}, [&expected_scale](int dest, auto& message) {
+      handler h;
+      std::memcpy(&h, message.data() + sizeof(uint16_t), sizeof(handler));
+      YGM_ASSERT_RELEASE(h.scale == expected_scale++);
+    });
+  }
+
+  return 0;
+}
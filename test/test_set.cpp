@@ -338,5 +338,72 @@ int main(int argc, char** argv) {
     }
   }
 
+  //
+  // Test flat_storage
+  {
+    using flat_set = ygm::container::set<int, ygm::container::flat_storage>;
+    static_assert(std::is_same_v<flat_set::storage_type,
+                                 ygm::container::flat_storage>);
+
+    flat_set iset(world);
+    int      num_items = 1000;
+    for (int i = 0; i < num_items; ++i) {
+      iset.async_insert(i);
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(iset.size() == num_items);
+    YGM_ASSERT_RELEASE(iset.count(num_items / 2) == 1);
+    YGM_ASSERT_RELEASE(iset.count(num_items) == 0);
+
+    static int found = 0;
+    for (int i = 0; i < num_items; ++i) {
+      iset.async_contains(i, [](bool contains, const int &i) {
+        found += contains;
+      });
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(world.all_reduce_sum(found) ==
+                       num_items * world.size());
+
+    for (int i = 0; i < num_items; i += 2) {
+      iset.async_erase(i);
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(iset.size() == num_items / 2);
+    iset.for_all([](const auto &item) { YGM_ASSERT_RELEASE(item % 2 == 1); });
+
+    // Inserts and lookups interleaved within one barrier
+    flat_set   cset(world);
+    static int already_contained = 0;
+    int        num_inserts       = 20000;
+    for (int i = 0; i < num_inserts; ++i) {
+      cset.async_insert_contains(i, [](bool contains, const int &i) {
+        already_contained += contains;
+      });
+    }
+    world.barrier();
+    YGM_ASSERT_RELEASE(cset.size() == num_inserts);
+    YGM_ASSERT_RELEASE(world.all_reduce_sum(already_contained) ==
+                       num_inserts * (world.size() - 1));
+  }
+
+  //
+  // Test async_contains by std::string_view
+  {
+    ygm::container::set<std::string> sset(world);
+    sset.async_insert("dog");
+    world.barrier();
+
+    static int found = 0;
+    auto       f     = [](bool contains, std::string_view value) {
+      found += contains && value == "dog";
+    };
+    sset.async_contains(std::string_view("dog"), f);
+    sset.async_contains(std::string_view("cat"), f);
+    world.barrier();
+    YGM_ASSERT_RELEASE(world.all_reduce_sum(found) == world.size());
+    YGM_ASSERT_RELEASE(sset.count(std::string_view("dog")) == 1);
+  }
+
   return 0;
 }
@@ -0,0 +1,123 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#undef NDEBUG
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <ygm/container/detail/sorted_vector_set.hpp>
+#include <ygm/detail/assert.hpp>
+
+using ygm::container::detail::sorted_vector_set;
+
+template <typename Flat, typename Expected>
+void check_equal(const Flat &flat, const Expected &expected) {
+  YGM_ASSERT_RELEASE(flat.size() == expected.size());
+  YGM_ASSERT_RELEASE(std::equal(flat.begin(), flat.end(), expected.begin()));
+}
+
+int main() {
+  //
+  // Test set semantics
+  {
+    sorted_vector_set<std::string, false> flat;
+    YGM_ASSERT_RELEASE(flat.empty());
+    flat.insert("dog");
+    flat.insert("cat");
+    flat.insert("dog");
+    YGM_ASSERT_RELEASE(flat.has_pending());
+    YGM_ASSERT_RELEASE(flat.size() == 2);
+    YGM_ASSERT_RELEASE(!flat.has_pending());
+    YGM_ASSERT_RELEASE(flat.count("dog") == 1);
+    YGM_ASSERT_RELEASE(flat.contains("cat"));
+    YGM_ASSERT_RELEASE(*flat.begin() == "cat");
+
+    // Duplicates of values already flushed are dropped too
+    flat.insert("dog");
+    YGM_ASSERT_RELEASE(flat.count("dog") == 1);
+    YGM_ASSERT_RELEASE(flat.erase("dog") == 1);
+    YGM_ASSERT_RELEASE(flat.erase("dog") == 0);
+    YGM_ASSERT_RELEASE(flat.size() == 1);
+
+    flat.clear();
+    YGM_ASSERT_RELEASE(flat.empty());
+  }
+
+  //
+  // Test lookups answer from the log without flushing a short one
+  {
+    sorted_vector_set<int, false> flat;
+    flat.insert(5);
+    flat.insert(5);
+    YGM_ASSERT_RELEASE(flat.count(5) == 1);
+    YGM_ASSERT_RELEASE(flat.contains(5));
+    YGM_ASSERT_RELEASE(!flat.contains(6));
+    YGM_ASSERT_RELEASE(flat.has_pending());
+
+    sorted_vector_set<int, true> flat_multi;
+    flat_multi.insert(5);
+    flat_multi.insert(5);
+    YGM_ASSERT_RELEASE(flat_multi.count(5) == 2);
+    YGM_ASSERT_RELEASE(flat_multi.has_pending());
+
+    // A long log is flushed by the next lookup
+    for (int i = 0; i < 10000; ++i) {
+      flat.insert(i);
+    }
+    YGM_ASSERT_RELEASE(flat.contains(9999));
+    YGM_ASSERT_RELEASE(!flat.has_pending());
+  }
+
+  //
+  // Test multiset semantics
+  {
+    sorted_vector_set<int, true> flat;
+    flat.insert(3);
+    flat.insert(1);
+    flat.insert(3);
+    YGM_ASSERT_RELEASE(flat.count(3) == 2);
+    flat.insert(3);
+    YGM_ASSERT_RELEASE(flat.count(3) == 3);
+    YGM_ASSERT_RELEASE(flat.erase(3) == 3);
+    YGM_ASSERT_RELEASE(flat.size() == 1);
+  }
+
+  //
+  // Test random inserts interleaved with flushes and erases against std::set
+  // and std::multiset
+  {
+    sorted_vector_set<uint64_t, false> flat_set;
+    sorted_vector_set<uint64_t, true>  flat_multiset;
+    std::set<uint64_t>                 expected_set;
+    std::multiset<uint64_t>            expected_multiset;
+    std::mt19937_64                    rng(42);
+    for (size_t i = 0; i < 100000; ++i) {
+      uint64_t value = rng() % 10000;
+      if (rng() % 10 == 0) {
+        YGM_ASSERT_RELEASE(flat_set.erase(value) == expected_set.erase(value));
+        YGM_ASSERT_RELEASE(flat_multiset.erase(value) ==
+                           expected_multiset.erase(value));
+      } else {
+        flat_set.insert(value);
+        flat_multiset.insert(value);
+        expected_set.insert(value);
+        expected_multiset.insert(value);
+      }
+      if (i % 1000 == 0) {
+        flat_set.flush();
+      }
+    }
+    check_equal(flat_set, expected_set);
+    check_equal(flat_multiset, expected_multiset);
+
+    sorted_vector_set<uint64_t, false> other;
+    other.swap(flat_set);
+    YGM_ASSERT_RELEASE(flat_set.empty());
+    check_equal(other, expected_set);
+  }
+
+  return 0;
+}